@@ -0,0 +1,132 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+
+// Per-channel smoothing assembled at compile time. A Chain runs each sample
+// through its stages in order, e.g.
+//
+//   Chain<Median<3>, Ema<1, 4>> co2; // drop single-sample spikes, then smooth
+//   float out = co2.addSample(in);
+//
+// Every stage keeps its state in fixed-size members and is called directly,
+// so a chain inlines to straight-line code: no heap, no virtual calls.
+// Non-finite samples (absent or invalid channels) pass through unchanged and
+// leave the state alone.
+
+namespace filters {
+
+// Median of the last Window samples; a spike shorter than half the window
+// never reaches the output. Windows 3 and 5, the ones in use, select the
+// median branchlessly with min/max over the buffer. Other windows, and the
+// first samples of window 5, insertion-sort a copy of the window, which
+// costs O(Window^2) and suits only small windows; a sorted window or a
+// heap pair would take over from about nine samples (bench_median).
+template <size_t Window>
+class Median
+{
+    static_assert(Window % 2 == 1, "window must be odd");
+
+public:
+    float addSample(float sample)
+    {
+        if constexpr (Window == 3)
+            return medianOfThree(sample);
+
+        mBuffer[mIndex] = sample;
+        mIndex = (mIndex + 1) % Window;
+        if (mCount < Window)
+            mCount++;
+        if constexpr (Window == 5)
+        {
+            if (mCount == 5)
+                return medianOfFive();
+        }
+
+        float sorted[Window];
+        for (size_t i = 0; i < mCount; i++)
+        {
+            const float v = mBuffer[i];
+            size_t j = i;
+            for (; j > 0 && sorted[j - 1] > v; j--)
+                sorted[j] = sorted[j - 1];
+            sorted[j] = v;
+        }
+        return sorted[mCount / 2];
+    }
+
+private:
+    float medianOfThree(float sample)
+    {
+        mBuffer[mIndex] = sample;
+        mIndex = mIndex == 2 ? 0 : mIndex + 1;
+        if (mCount < 3)
+            mCount++;
+        if (mCount == 1)
+            return sample;
+        const float a = mBuffer[0], b = mBuffer[1];
+        if (mCount == 2)
+            return std::max(a, b); // the upper of two, as the sorted path
+        return medianOfThree(a, b, mBuffer[2]);
+    }
+
+    static float medianOfThree(float a, float b, float c)
+    {
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    }
+
+    // Neither the lower of the two pair minima nor the upper of the two pair
+    // maxima can be the median of five; it is the median of the rest.
+    float medianOfFive() const
+    {
+        const float a = mBuffer[0], b = mBuffer[1], c = mBuffer[2], d = mBuffer[3];
+        return medianOfThree(mBuffer[4], std::max(std::min(a, b), std::min(c, d)),
+                             std::min(std::max(a, b), std::max(c, d)));
+    }
+
+    float mBuffer[Window] = {};
+    size_t mIndex = 0;
+    size_t mCount = 0;
+};
+
+// Exponential moving average with weight Num/Den for the new sample; the
+// first sample seeds it.
+template <int Num, int Den>
+class Ema
+{
+    static_assert(Num > 0 && Num <= Den, "weight must be in (0, 1]");
+    static constexpr float kAlpha = static_cast<float>(Num) / static_cast<float>(Den);
+
+public:
+    float addSample(float sample)
+    {
+        mValue = mSeeded ? mValue + kAlpha * (sample - mValue) : sample;
+        mSeeded = true;
+        return mValue;
+    }
+
+private:
+    float mValue = 0.0f;
+    bool mSeeded = false;
+};
+
+template <typename... Stages>
+class Chain
+{
+    static_assert(sizeof...(Stages) > 0, "a chain needs a stage");
+
+public:
+    float addSample(float sample)
+    {
+        if (!std::isfinite(sample))
+            return sample;
+        std::apply([&sample](Stages &...stage) { ((sample = stage.addSample(sample)), ...); }, mStages);
+        return sample;
+    }
+
+private:
+    std::tuple<Stages...> mStages;
+};
+
+} // namespace filters
@@ -11,6 +11,8 @@ public:
     void CreateAirQualityEndpoint();
     void StartMeasurements();
     bool ReadSensor(sen66_data_t *out);
+    bool ReadSensor(sen66_data_t *out, Sen66PhaseLock &phaseLock);
+    bool ReadSensor(sen66_record_t *out, Sen66PhaseLock &phaseLock, uint8_t frames);
     void SetFloatAttribute(uint16_t endpoint, uint32_t clusterId, uint32_t attributeId, float value);
     void UpdateAirQualityAttributes(const sen66_data_t *data);
 
@@ -0,0 +1,65 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+// Simple moving average over the last Window samples of N channels that are
+// sampled together (e.g. PM1.0/PM2.5/PM10). Fixed capacity, no heap.
+//
+// Storage is structure-of-arrays: one row of N channel values per time slot,
+// so an update is a single loop over contiguous floats that the compiler can
+// vectorise. Window is a power of two and the slot index wraps with a mask.
+// Until Window samples have arrived, the mean is over the samples so far
+// rather than over a window padded with zeros. The running sums are rebuilt
+// from the history every kResumSamples, so rounding errors cannot accumulate.
+template <size_t N, size_t Window>
+class MultiChannelSma
+{
+    static_assert(N > 0, "no channels");
+    static_assert(Window != 0 && (Window & (Window - 1)) == 0, "window must be a power of two");
+
+public:
+    using Samples = std::array<float, N>;
+    static constexpr size_t kResumSamples = Window < 256 ? 256 : Window;
+
+    // Adds one sample per channel and returns the per-channel means.
+    const Samples &addSamples(const Samples &samples)
+    {
+        if (mCount < Window)
+            mCount++;
+        if (++mSinceResum == kResumSamples)
+            resum();
+        const float scale = mCount == Window ? kInvWindow : 1.0f / static_cast<float>(mCount);
+
+        Samples &slot = mHistory[mIndex];
+        for (size_t c = 0; c < N; c++)
+        {
+            const float sum = mSum[c] + (samples[c] - slot[c]);
+            mSum[c] = sum;
+            slot[c] = samples[c];
+            mMean[c] = sum * scale;
+        }
+        mIndex = (mIndex + 1) & (Window - 1);
+        return mMean;
+    }
+
+    size_t count() const { return mCount; }
+
+private:
+    static constexpr float kInvWindow = 1.0f / static_cast<float>(Window);
+
+    void resum()
+    {
+        mSinceResum = 0;
+        mSum = {};
+        for (const Samples &slot : mHistory)
+            for (size_t c = 0; c < N; c++)
+                mSum[c] += slot[c];
+    }
+
+    std::array<Samples, Window> mHistory{}; // [slot][channel]
+    Samples mSum{};
+    Samples mMean{};
+    size_t mIndex = 0;
+    size_t mCount = 0;
+    size_t mSinceResum = 0;
+};
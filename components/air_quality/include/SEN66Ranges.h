@@ -13,6 +13,8 @@ static constexpr float VOC_MIN  = 0.0f;
 static constexpr float VOC_MAX  = 500.0f;
 static constexpr float NOX_MIN  = 0.0f;
 static constexpr float NOX_MAX  = 500.0f;
+static constexpr float HCHO_MIN = 0.0f;    // ppb, SEN68
+static constexpr float HCHO_MAX = 1000.0f;
 
 // environmental
 static constexpr float TEMP_MIN = -40.0f;
@@ -1,4 +1,5 @@
 #include "AirQualityClassifier.h"
+#include "sen6x_traits.h"
 
 AirQualityLevel AirQualityClassifier::classifyCo2(uint16_t co2_ppm) {
     for (const auto& [threshold, level] : CO2_THRESHOLDS) {
@@ -39,8 +40,11 @@ AirQualityLevel AirQualityClassifier::classify(const sen66_data_t* data) {
         return AirQualityLevel::kUnknown;
     }
 
-    // Classify CO₂
-    AirQualityLevel co2Level = classifyCo2(data->co2_equivalent);
+    // Classify CO₂; modules without it leave the PM levels to decide
+    AirQualityLevel co2Level = AirQualityLevel::kGood;
+    if constexpr (sen6x::Active::has(sen6x::CO2))
+        co2Level = std::isnan(data->co2_equivalent) ? AirQualityLevel::kUnknown
+                                                    : classifyCo2(data->co2_equivalent);
 
     // Calculate AQI for PM2.5 and PM10
     float aqi25 = calculateAqi(data->pm2_5, PM25_BREAKPOINTS);
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <map>
 #include "sen66_i2c.h"
+#include "sen6x_traits.h"
 #include "AirQualityClassifier.h"
 #include "SEN66Ranges.h"
 #include <esp_matter.h>
@@ -22,6 +23,10 @@ static const char *TAG = "MatterAirQuality";
 using namespace esp_matter;
 using namespace chip::app::Clusters;
 
+// Channels of the module this build is for (sen6x_traits.h); clusters and
+// updates for the others are compiled out.
+using Sensor = sen6x::Active;
+
 //------------------------------------------------------------------------------
 // Helper to create a “ConcentrationMeasurement” cluster + its NumericMeasurement
 //------------------------------------------------------------------------------
@@ -69,7 +74,8 @@ void MatterAirQuality::CreateAirQualityEndpoint()
     AddStandardMeasurementClusters();
     AddCustomMeasurementClusters();
 
-    ESP_LOGI(TAG, "Air Quality endpoint created successfully. Some features may not be supported and have been skipped.");
+    ESP_LOGI(TAG, "Air Quality endpoint created for %s. Some features may not be supported and have been skipped.",
+             Sensor::kName);
 }
 
 void MatterAirQuality::StartMeasurements()
@@ -82,6 +88,16 @@ bool MatterAirQuality::ReadSensor(sen66_data_t *out)
     return sen66_get_measurement(out);
 }
 
+bool MatterAirQuality::ReadSensor(sen66_data_t *out, Sen66PhaseLock &phaseLock)
+{
+    return sen66_get_measurement(phaseLock, out);
+}
+
+bool MatterAirQuality::ReadSensor(sen66_record_t *out, Sen66PhaseLock &phaseLock, uint8_t frames)
+{
+    return sen66_get_measurement(phaseLock, frames, out);
+}
+
 void MatterAirQuality::UpdateAirQualityAttributes(const sen66_data_t *data)
 {
     if (!m_air_quality_endpoint) {
@@ -130,22 +146,32 @@ void MatterAirQuality::AddAirQualityFeatures()
 void MatterAirQuality::AddStandardMeasurementClusters()
 {
     using namespace sen66_ranges;
-    AddCluster<cluster::temperature_measurement::config_t>(
-        cluster::temperature_measurement::create, "TemperatureMeasurement", TEMP_MIN, TEMP_MAX); 
+    if constexpr (Sensor::has(sen6x::TEMPERATURE))
+        AddCluster<cluster::temperature_measurement::config_t>(
+            cluster::temperature_measurement::create, "TemperatureMeasurement", TEMP_MIN, TEMP_MAX);
 
-    AddCluster<cluster::relative_humidity_measurement::config_t>(
-        cluster::relative_humidity_measurement::create, "RelativeHumidityMeasurement", HUM_MIN, HUM_MAX);
+    if constexpr (Sensor::has(sen6x::HUMIDITY))
+        AddCluster<cluster::relative_humidity_measurement::config_t>(
+            cluster::relative_humidity_measurement::create, "RelativeHumidityMeasurement", HUM_MIN, HUM_MAX);
 }
 
 void MatterAirQuality::AddCustomMeasurementClusters()
 {
     using namespace sen66_ranges;
-    ADD_MEASUREMENT_CLUSTER(pm1_concentration_measurement, Pm1ConcentrationMeasurement, kAir, kUgm3,PM_MIN, PM_MAX);
-    ADD_MEASUREMENT_CLUSTER(pm25_concentration_measurement, Pm25ConcentrationMeasurement, kAir, kUgm3,PM_MIN, PM_MAX);
-    ADD_MEASUREMENT_CLUSTER(pm10_concentration_measurement, Pm10ConcentrationMeasurement, kAir, kUgm3,PM_MIN, PM_MAX);
-    ADD_MEASUREMENT_CLUSTER(total_volatile_organic_compounds_concentration_measurement, TotalVolatileOrganicCompoundsConcentrationMeasurement, kAir, kPpm,VOC_MIN, VOC_MAX);    
-    ADD_MEASUREMENT_CLUSTER(carbon_dioxide_concentration_measurement, CarbonDioxideConcentrationMeasurement, kAir, kPpm,ECO2_MIN, ECO2_MAX);
-    ADD_MEASUREMENT_CLUSTER(nitrogen_dioxide_concentration_measurement, NitrogenDioxideConcentrationMeasurement, kAir, kPpm,NOX_MIN, NOX_MAX);
+    if constexpr (Sensor::has(sen6x::PM1_0))
+        ADD_MEASUREMENT_CLUSTER(pm1_concentration_measurement, Pm1ConcentrationMeasurement, kAir, kUgm3,PM_MIN, PM_MAX);
+    if constexpr (Sensor::has(sen6x::PM2_5))
+        ADD_MEASUREMENT_CLUSTER(pm25_concentration_measurement, Pm25ConcentrationMeasurement, kAir, kUgm3,PM_MIN, PM_MAX);
+    if constexpr (Sensor::has(sen6x::PM10_0))
+        ADD_MEASUREMENT_CLUSTER(pm10_concentration_measurement, Pm10ConcentrationMeasurement, kAir, kUgm3,PM_MIN, PM_MAX);
+    if constexpr (Sensor::has(sen6x::VOC_INDEX))
+        ADD_MEASUREMENT_CLUSTER(total_volatile_organic_compounds_concentration_measurement, TotalVolatileOrganicCompoundsConcentrationMeasurement, kAir, kPpm,VOC_MIN, VOC_MAX);
+    if constexpr (Sensor::has(sen6x::CO2))
+        ADD_MEASUREMENT_CLUSTER(carbon_dioxide_concentration_measurement, CarbonDioxideConcentrationMeasurement, kAir, kPpm,ECO2_MIN, ECO2_MAX);
+    if constexpr (Sensor::has(sen6x::NOX_INDEX))
+        ADD_MEASUREMENT_CLUSTER(nitrogen_dioxide_concentration_measurement, NitrogenDioxideConcentrationMeasurement, kAir, kPpm,NOX_MIN, NOX_MAX);
+    if constexpr (Sensor::has(sen6x::HCHO))
+        ADD_MEASUREMENT_CLUSTER(formaldehyde_concentration_measurement, FormaldehydeConcentrationMeasurement, kAir, kPpb,HCHO_MIN, HCHO_MAX);
 }
 
 template <typename ConfigType>
@@ -162,12 +188,12 @@ void MatterAirQuality::AddCluster(std::function<cluster_t *(endpoint_t *, Config
 
 void MatterAirQuality::UpdateTemperatureAndHumidity(uint16_t endpointId, const sen66_data_t *data)
 {
-    if (!std::isnan(data->temperature)) {
+    if (Sensor::has(sen6x::TEMPERATURE) && !std::isnan(data->temperature)) {
         int16_t temp_val = static_cast<int16_t>(data->temperature * 100.0f); // .01°C units
         UpdateAttribute(endpointId, TemperatureMeasurement::Id, TemperatureMeasurement::Attributes::MeasuredValue::Id, temp_val);
     }
 
-    if (!std::isnan(data->humidity)) {
+    if (Sensor::has(sen6x::HUMIDITY) && !std::isnan(data->humidity)) {
         int16_t hum_val = static_cast<int16_t>(data->humidity * 100.0f); // .01%RH units
         UpdateAttribute(endpointId, RelativeHumidityMeasurement::Id, RelativeHumidityMeasurement::Attributes::MeasuredValue::Id, hum_val);
     }
@@ -175,30 +201,34 @@ void MatterAirQuality::UpdateTemperatureAndHumidity(uint16_t endpointId, const s
 
 void MatterAirQuality::UpdateConcentrationMeasurements(uint16_t endpointId, const sen66_data_t *data)
 {
-    if (!std::isnan(data->co2_equivalent)) {
+    if (Sensor::has(sen6x::CO2) && !std::isnan(data->co2_equivalent)) {
         UpdateAttribute(endpointId, CarbonDioxideConcentrationMeasurement::Id,
                         CarbonDioxideConcentrationMeasurement::Attributes::MeasuredValue::Id, data->co2_equivalent);
     }
-    if (!std::isnan(data->pm1_0)) {
+    if (Sensor::has(sen6x::PM1_0) && !std::isnan(data->pm1_0)) {
         UpdateAttribute(endpointId, Pm1ConcentrationMeasurement::Id,
                         Pm1ConcentrationMeasurement::Attributes::MeasuredValue::Id, data->pm1_0);
     }
-    if (!std::isnan(data->pm2_5)) {
+    if (Sensor::has(sen6x::PM2_5) && !std::isnan(data->pm2_5)) {
         UpdateAttribute(endpointId, Pm25ConcentrationMeasurement::Id,
                         Pm25ConcentrationMeasurement::Attributes::MeasuredValue::Id, data->pm2_5);
     }
-    if (!std::isnan(data->pm10_0)) {
+    if (Sensor::has(sen6x::PM10_0) && !std::isnan(data->pm10_0)) {
         UpdateAttribute(endpointId, Pm10ConcentrationMeasurement::Id,
                         Pm10ConcentrationMeasurement::Attributes::MeasuredValue::Id, data->pm10_0);
     }
-    if (!std::isnan(data->voc_index)) {
+    if (Sensor::has(sen6x::VOC_INDEX) && !std::isnan(data->voc_index)) {
         UpdateAttribute(endpointId, TotalVolatileOrganicCompoundsConcentrationMeasurement::Id,
                         TotalVolatileOrganicCompoundsConcentrationMeasurement::Attributes::MeasuredValue::Id, data->voc_index);
     }
-    if (!std::isnan(data->nox_index)) {
+    if (Sensor::has(sen6x::NOX_INDEX) && !std::isnan(data->nox_index)) {
         UpdateAttribute(endpointId, NitrogenDioxideConcentrationMeasurement::Id,
                         NitrogenDioxideConcentrationMeasurement::Attributes::MeasuredValue::Id, data->nox_index);
     }
+    if (Sensor::has(sen6x::HCHO) && !std::isnan(data->hcho)) {
+        UpdateAttribute(endpointId, FormaldehydeConcentrationMeasurement::Id,
+                        FormaldehydeConcentrationMeasurement::Attributes::MeasuredValue::Id, data->hcho);
+    }
 }
 
 void MatterAirQuality::UpdateAirQualityLevel(uint16_t endpointId, const sen66_data_t *data)
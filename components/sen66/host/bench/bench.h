@@ -0,0 +1,35 @@
+#pragma once
+
+// Timing helpers shared by the host benchmarks.
+
+#include <chrono>
+#include <cstdint>
+
+namespace bench {
+
+// Keep value alive so the compiler cannot drop the work that produced it.
+template <typename T>
+inline void keep(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Best of five runs of iterations calls to fn, in nanoseconds per call. The
+// minimum filters out scheduling noise from other processes.
+template <typename Fn>
+double nsPerCall(uint32_t iterations, Fn &&fn)
+{
+    double best = 0;
+    for (int run = 0; run < 5; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++)
+            fn(i);
+        const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+        const double ns = took.count() / iterations;
+        if (run == 0 || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+} // namespace bench
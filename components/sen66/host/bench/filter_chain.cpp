@@ -0,0 +1,58 @@
+// Per-sample cost of the filter chains SensorTask runs on each channel,
+// against the 5-sample SmaFilter that used to smooth only the PM channels.
+//
+// Each filter is stepped through an out-of-line call, so its state lives in
+// memory as it does in the task, where one sample arrives every few seconds.
+// The input is a CO2-like signal with noise and occasional spikes.
+
+#include "bench.h"
+#include "legacy_sma.h"
+
+#include <FilterChain.h>
+
+#include <cstdio>
+
+namespace {
+
+using namespace filters;
+
+constexpr uint32_t kIterations = 2000000;
+constexpr uint32_t kSamples = 4096; // power of two, indexed with a mask
+
+float gInput[kSamples];
+
+template <typename Filter>
+__attribute__((noinline)) float step(Filter &filter, float sample)
+{
+    return filter.addSample(sample);
+}
+
+template <typename Filter>
+void run(const char *name, Filter filter)
+{
+    const double ns = bench::nsPerCall(kIterations, [&filter](uint32_t i) {
+        bench::keep(step(filter, gInput[i & (kSamples - 1)]));
+    });
+    std::printf("  %-28s %6.1f ns %6zu B\n", name, ns, sizeof(Filter));
+}
+
+} // namespace
+
+int main()
+{
+    uint32_t seed = 1;
+    for (float &sample : gInput) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = 600.0f + static_cast<float>((seed >> 16) % 40);
+        if ((seed >> 8) % 64 == 0)
+            sample += 400.0f;
+    }
+
+    std::printf("per sample, state size (the SmaFilter buffer is on the heap)\n");
+    run("SmaFilter(5)", bench::LegacySma(5));
+    run("Chain<Median<3>, Ema<1,4>>", Chain<Median<3>, Ema<1, 4>>());
+    run("Chain<Median<5>>", Chain<Median<5>>());
+    run("Chain<Ema<1,2>>", Chain<Ema<1, 2>>());
+    run("Chain<Ema<1,3>>", Chain<Ema<1, 3>>());
+    return 0;
+}
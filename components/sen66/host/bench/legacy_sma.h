@@ -0,0 +1,32 @@
+#pragma once
+
+// SmaFilter as the tree had it before FilterChain.h and MultiChannelSma.h
+// replaced it, kept here as the baseline for the filter benchmarks.
+
+#include <cstddef>
+#include <vector>
+
+namespace bench {
+
+class LegacySma
+{
+public:
+    explicit LegacySma(size_t window) : mWindow(window), mBuffer(window, 0) {}
+
+    float addSample(float sample)
+    {
+        mSum -= mBuffer[mIndex];
+        mBuffer[mIndex] = sample;
+        mSum += sample;
+        mIndex = (mIndex + 1) % mWindow;
+        return mSum / static_cast<float>(mWindow);
+    }
+
+private:
+    size_t mWindow;
+    float mSum = 0.0f;
+    size_t mIndex = 0;
+    std::vector<float> mBuffer;
+};
+
+} // namespace bench
@@ -0,0 +1,102 @@
+// filters::Median against the sorted-window median it replaced, which kept
+// the window sorted alongside the arrival order, binary-searching the
+// outgoing and incoming samples and shifting the values between them.
+// filters::Median selects the median of five with min/max and
+// insertion-sorts a copy of any other window.
+//
+// Both are stepped out of line over the same noisy input with spikes and
+// must produce the same outputs. SensorTask uses windows 3 and 5; window 3
+// takes the branchless median of three in both, so it is not compared.
+
+#include "bench.h"
+
+#include <FilterChain.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+constexpr uint32_t kIterations = 2000000;
+constexpr uint32_t kSamples = 4096; // power of two, indexed with a mask
+
+float gInput[kSamples];
+
+template <size_t Window>
+class SortedMedian
+{
+public:
+    float addSample(float sample)
+    {
+        float *end = mSorted + mCount;
+        if (mCount == Window) {
+            float *out = std::lower_bound(mSorted, end, mBuffer[mIndex]);
+            std::copy(out + 1, end, out);
+            end--;
+        } else {
+            mCount++;
+        }
+        float *in = std::upper_bound(mSorted, end, sample);
+        std::copy_backward(in, end, end + 1);
+        *in = sample;
+
+        mBuffer[mIndex] = sample;
+        mIndex = (mIndex + 1) % Window;
+        return mSorted[mCount / 2];
+    }
+
+private:
+    float mBuffer[Window] = {};
+    float mSorted[Window] = {};
+    size_t mIndex = 0;
+    size_t mCount = 0;
+};
+
+template <typename Filter>
+__attribute__((noinline)) float step(Filter &filter, float sample)
+{
+    return filter.addSample(sample);
+}
+
+template <typename Filter>
+double time(Filter &filter)
+{
+    return bench::nsPerCall(kIterations, [&filter](uint32_t i) {
+        bench::keep(step(filter, gInput[i & (kSamples - 1)]));
+    });
+}
+
+template <size_t Window>
+bool compare()
+{
+    filters::Median<Window> median, medianTimed;
+    SortedMedian<Window> sorted, sortedTimed;
+    uint32_t differ = 0;
+    for (uint32_t i = 0; i < 2 * kSamples; i++) {
+        const float sample = gInput[i & (kSamples - 1)];
+        differ += step(median, sample) != step(sorted, sample);
+    }
+    const double medianNs = time(medianTimed);
+    const double sortedNs = time(sortedTimed);
+    std::printf("  %6zu %12.1f %12.1f%s\n", Window, medianNs, sortedNs, differ ? "  OUTPUTS DIFFER" : "");
+    return differ == 0;
+}
+
+} // namespace
+
+int main()
+{
+    uint32_t seed = 1;
+    for (float &sample : gInput) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = 10.0f + static_cast<float>((seed >> 16) % 40) / 10.0f;
+        if ((seed >> 8) % 32 == 0)
+            sample += 60.0f;
+    }
+
+    std::printf("ns per sample\n  %6s %12s %12s\n", "window", "Median", "sorted");
+    bool same = compare<5>();
+    same &= compare<9>();
+    same &= compare<31>();
+    return same ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+// The PM moving average: one MultiChannelSma<3, 4> against the three
+// SmaFilter(4) it replaced, one per PM channel.
+//
+// Each step is an out-of-line call on filters whose state lives in memory,
+// as in the task; a fully inlined loop would let the compiler keep the old
+// filter's single sum in a register, which one sample set every few seconds
+// never gets. Footprint counts the object plus the heap buffers it owns.
+
+#include "bench.h"
+#include "legacy_sma.h"
+
+#include <MultiChannelSma.h>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr size_t kWindow = 4;
+constexpr uint32_t kIterations = 2000000;
+constexpr uint32_t kSets = 4096; // power of two, indexed with a mask
+
+struct LegacyPm
+{
+    bench::LegacySma pm1{kWindow}, pm25{kWindow}, pm10{kWindow};
+};
+
+using Samples = MultiChannelSma<3, kWindow>::Samples;
+
+Samples gInput[kSets];
+
+__attribute__((noinline)) Samples stepLegacy(LegacyPm &f, const Samples &in)
+{
+    return {f.pm1.addSample(in[0]), f.pm25.addSample(in[1]), f.pm10.addSample(in[2])};
+}
+
+__attribute__((noinline)) Samples stepMulti(MultiChannelSma<3, kWindow> &f, const Samples &in)
+{
+    return f.addSamples(in);
+}
+
+} // namespace
+
+int main()
+{
+    uint32_t seed = 1;
+    for (Samples &set : gInput) {
+        for (float &v : set) {
+            seed = seed * 1664525u + 1013904223u;
+            v = static_cast<float>((seed >> 16) % 500) / 10.0f;
+        }
+    }
+
+    // After the legacy window has filled, both compute the same means.
+    LegacyPm legacy;
+    MultiChannelSma<3, kWindow> multi;
+    float maxDiff = 0;
+    for (uint32_t i = 0; i < kSets; i++) {
+        const Samples a = stepLegacy(legacy, gInput[i]);
+        const Samples b = stepMulti(multi, gInput[i]);
+        for (size_t c = 0; i >= kWindow && c < 3; c++)
+            maxDiff = std::fmax(maxDiff, std::fabs(a[c] - b[c]));
+    }
+
+    const double legacyNs = bench::nsPerCall(kIterations, [&legacy](uint32_t i) {
+        bench::keep(stepLegacy(legacy, gInput[i & (kSets - 1)]));
+    });
+    const double multiNs = bench::nsPerCall(kIterations, [&multi](uint32_t i) {
+        bench::keep(stepMulti(multi, gInput[i & (kSets - 1)]));
+    });
+
+    const size_t legacyBytes = sizeof(LegacyPm) + 3 * kWindow * sizeof(float);
+    std::printf("per PM sample set (3 channels), window %zu:\n", kWindow);
+    std::printf("  3x SmaFilter(%zu)         %6.1f ns %5zu B (%zu B on the heap, 3 allocations)\n", kWindow,
+                legacyNs, legacyBytes, 3 * kWindow * sizeof(float));
+    std::printf("  MultiChannelSma<3, %zu>    %6.1f ns %5zu B (no heap)\n", kWindow, multiNs,
+                sizeof(MultiChannelSma<3, kWindow>));
+    std::printf("  max difference after warm-up %.1e\n", static_cast<double>(maxDiff));
+    return maxDiff < 1e-3f ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+// Response latency of a command with a response (get_data_ready), polled as
+// the driver does it, against sleeping its full datasheet execution time.
+//
+// The simulated sensor is made to answer after a range of delays up to the
+// 20 ms datasheet maximum. For each, the command is issued repeatedly through
+// the blocking driver; latency is call to return, and busy CPU is the part
+// of the waits busy-waited rather than yielded (sen66_sim::waitTotals). The
+// sleeping driver always took exec_time_us plus the transfers, and with the
+// yielding HAL its 20 ms are two whole ticks with no busy part.
+//
+// Polling must never be slower than that sleep, whenever the sensor answers;
+// the benchmark fails if it is.
+
+#include "sen66_commands.h"
+#include "sen66_i2c.h"
+#include "sen66_sim.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c_hal.h"
+
+#include <cstdio>
+
+namespace {
+
+constexpr int kCalls = 100;
+
+} // namespace
+
+int main()
+{
+    sen66_sim::Device device;
+    sensirion_i2c_hal_init();
+    sen66_sim::attach(0, SEN66_I2C_ADDR_6B, &device);
+    sen66_ctx_t ctx;
+    sen66_init(&ctx, 0, SEN66_I2C_ADDR_6B);
+
+    const sen66::Command &command = sen66::cmd::get_data_ready;
+    std::printf("get_data_ready, exec_time %u us, min_exec %u us\n", static_cast<unsigned>(command.exec_time_us),
+                static_cast<unsigned>(command.min_exec_us));
+    std::printf("%10s %12s %10s %8s %12s\n", "ready [us]", "latency [us]", "busy [us]", "polls", "sleep [us]");
+
+    int slower = 0;
+    for (int64_t delayUs : {1000, 2000, 3000, 5000, 8000, 10000, 11000, 12000, 16000, 19000, 19900}) {
+        device.setResponseDelayUs(delayUs);
+        sensirion_i2c_hal_stats_t before, after;
+        sensirion_i2c_hal_get_stats(&before);
+        sen66_sim::resetWaitTotals();
+
+        int64_t latencyUs = 0;
+        int failed = 0;
+        for (int i = 0; i < kCalls; i++) {
+            uint8_t padding;
+            bool ready;
+            const int64_t start = sen66_sim::nowUs();
+            if (sen66_get_data_ready(&ctx, &padding, &ready) != NO_ERROR)
+                failed++;
+            latencyUs += sen66_sim::nowUs() - start;
+        }
+
+        sensirion_i2c_hal_get_stats(&after);
+        // Write, then one successful read after the sleep.
+        const int64_t sleepingUs = command.exec_time_us + 90 * (1 + command.txBytes()) + 90 * (1 + command.rx_words * 3);
+        const bool late = latencyUs / kCalls > sleepingUs;
+        slower += late;
+        std::printf("%10lld %12lld %10llu %8.1f %12lld%s%s\n", static_cast<long long>(delayUs),
+                    static_cast<long long>(latencyUs / kCalls),
+                    static_cast<unsigned long long>(sen66_sim::waitTotals().busyUs / kCalls),
+                    static_cast<double>(after.poll_nacks - before.poll_nacks) / kCalls + 1,
+                    static_cast<long long>(sleepingUs), failed ? "  FAILED" : "", late ? "  SLOWER" : "");
+        slower += failed != 0;
+    }
+    if (slower != 0) {
+        std::printf("polling lost to the fixed sleep, or failed, at %d delays\n", slower);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+// CPU time the acquisition task hands back to the scheduler per read cycle.
+//
+// Runs phase-locked measurement cycles against the simulated sensor and
+// splits every wait the way the ESP-IDF HAL spends it (sen66_sim::waitTotals).
+// Before the HAL yielded, sensirion_i2c_hal_sleep_usec() busy-waited all of
+// its time in esp_rom_delay_us(), so the "busy-only" column is the whole
+// sleep total. Virtual time, so the figures are exact and repeatable.
+
+#include "sen66_sensor.h"
+#include "sen66_sim.h"
+#include "sensirion_i2c_hal.h"
+#include "freertos/FreeRTOS.h"
+
+#include <cstdio>
+
+namespace {
+
+constexpr int kWarmUpCycles = 20;   // until the phase lock holds
+constexpr int kCycles = 1000;
+constexpr int64_t kIntervalUs = 5 * 1000 * 1000;
+
+} // namespace
+
+int main()
+{
+    sen66_sim::Device device;
+    device.setPeriodUs(1004 * 1000);
+    sen66_sim::attach(0, SEN66_I2C_ADDR_6B, &device);
+
+    const sen66_config_t config = sen66_default_config();
+    if (!sen66_bring_up(&config)) {
+        std::fprintf(stderr, "bring-up failed\n");
+        return 1;
+    }
+
+    Sen66PhaseLock lock;
+    sen66_record_t record;
+    uint64_t busUs = 0, sleepUs = 0, cycleUs = 0;
+    int failed = 0;
+    int64_t due = sen66_sim::nowUs();
+
+    for (int i = 0; i < kWarmUpCycles + kCycles; i++) {
+        if (i == kWarmUpCycles) {
+            sensirion_i2c_hal_get_time_totals(&busUs, &sleepUs);
+            sen66_sim::resetWaitTotals();
+            cycleUs = 0;
+            failed = 0;
+        }
+        due += kIntervalUs;
+        const int64_t at = lock.nextReadUs(due);
+        if (at > sen66_sim::nowUs())
+            sen66_sim::advanceUs(at - sen66_sim::nowUs());
+        const int64_t start = sen66_sim::nowUs();
+        if (!sen66_get_measurement(sen66_default_ctx(), lock, SEN66_FRAME_VALUES, &record))
+            failed++;
+        cycleUs += sen66_sim::nowUs() - start;
+    }
+
+    uint64_t busEnd, sleepEnd;
+    sensirion_i2c_hal_get_time_totals(&busEnd, &sleepEnd);
+    const sen66_sim::WaitTotals waits = sen66_sim::waitTotals();
+    const double n = kCycles;
+
+    std::printf("%d phase-locked cycles (%d failed), per cycle:\n", kCycles, failed);
+    std::printf("  cycle      %8.0f us\n", cycleUs / n);
+    std::printf("  bus        %8.0f us\n", (busEnd - busUs) / n);
+    std::printf("  sleep      %8.0f us\n", (sleepEnd - sleepUs) / n);
+    std::printf("  busy-only  %8.0f us CPU  (esp_rom_delay_us for every sleep)\n", (sleepEnd - sleepUs) / n);
+    std::printf("  busy       %8.0f us CPU  (sub-tick remainders)\n", waits.busyUs / n);
+    std::printf("  yielded    %8.0f us      (vTaskDelay, %d ms tick)\n", waits.yieldedUs / n, portTICK_PERIOD_MS);
+    std::printf("  freed      %8.0f us CPU\n", (sleepEnd - sleepUs - waits.busyUs) / n);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+// Timer dispatch latency with the acquisition on the esp_timer task, as
+// SensorTask ran it before, against a callback that only wakes the
+// acquisition task.
+//
+// Every esp_timer callback runs on the one esp_timer task, in due order. A
+// periodic system timer (kSystemPeriodUs, standing in for the Wi-Fi and
+// Matter timers) shares it with the sensor timer. Phase-locked cycles from a
+// cold start, the first relocks included, run against the simulated sensor;
+// each cycle's duration is taken from the virtual clock. With the cycle in
+// the callback, every system expiry that falls inside a cycle is dispatched
+// when the cycle ends. With the callback handing over, the task is free
+// again right away; its notify and the task switch cost microseconds on
+// target and are not modelled, so the "task" row is the floor the on-target
+// log (SensorTask::logLatency) is compared against.
+//
+// Only the I2C part of the old callback is counted: the Matter update and
+// NVS commit it also ran make the "callback" figures a lower bound.
+
+#include "sen66_sensor.h"
+#include "sen66_sim.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr int kCycles = 1000;
+constexpr int64_t kIntervalUs = 5 * 1000 * 1000;
+constexpr int64_t kSystemPeriodUs = 10 * 1000;
+
+struct Cycle {
+    int64_t startUs;
+    int64_t durationUs;
+};
+
+struct Latency {
+    uint64_t count = 0;
+    uint64_t delayed = 0; // dispatched 1 ms or more late
+    int64_t sumUs = 0;
+    int64_t maxUs = 0;
+
+    void add(int64_t us)
+    {
+        count++;
+        delayed += us >= 1000;
+        sumUs += us;
+        maxUs = std::max(maxUs, us);
+    }
+};
+
+// Dispatch latency of the system timer's expiries between fromUs and toUs
+// when the esp_timer task is busy for each of cycles.
+Latency systemTimer(const std::vector<Cycle> &cycles, int64_t fromUs, int64_t toUs, bool inCallback)
+{
+    Latency latency;
+    auto busy = cycles.begin();
+    for (int64_t due = fromUs; due < toUs; due += kSystemPeriodUs) {
+        while (busy != cycles.end() && busy->startUs + busy->durationUs <= due)
+            ++busy;
+        const bool blocked = inCallback && busy != cycles.end() && busy->startUs <= due;
+        latency.add(blocked ? busy->startUs + busy->durationUs - due : 0);
+    }
+    return latency;
+}
+
+void print(const char *path, const Latency &system)
+{
+    std::printf("%-10s %10.0f %10lld %9.2f%%\n", path, static_cast<double>(system.sumUs) / system.count,
+                static_cast<long long>(system.maxUs), 100.0 * system.delayed / system.count);
+}
+
+} // namespace
+
+int main()
+{
+    sen66_sim::Device device;
+    device.setPeriodUs(1004 * 1000);
+    sen66_sim::attach(0, SEN66_I2C_ADDR_6B, &device);
+
+    const sen66_config_t config = sen66_default_config();
+    if (!sen66_bring_up(&config)) {
+        std::fprintf(stderr, "bring-up failed\n");
+        return 1;
+    }
+
+    Sen66PhaseLock lock;
+    sen66_record_t record;
+    std::vector<Cycle> cycles;
+    int failed = 0;
+    const int64_t fromUs = sen66_sim::nowUs();
+    int64_t due = fromUs;
+
+    for (int i = 0; i < kCycles; i++) {
+        due += kIntervalUs;
+        const int64_t at = lock.nextReadUs(due);
+        if (at > sen66_sim::nowUs())
+            sen66_sim::advanceUs(at - sen66_sim::nowUs());
+        const int64_t start = sen66_sim::nowUs();
+        if (!sen66_get_measurement(sen66_default_ctx(), lock, SEN66_FRAME_VALUES, &record))
+            failed++;
+        cycles.push_back({start, sen66_sim::nowUs() - start});
+    }
+    const int64_t toUs = sen66_sim::nowUs();
+
+    int64_t longestUs = 0;
+    for (const Cycle &cycle : cycles)
+        longestUs = std::max(longestUs, cycle.durationUs);
+    std::printf("%d cycles (%d failed), longest %lld us; system timer every %lld us\n", kCycles, failed,
+                static_cast<long long>(longestUs), static_cast<long long>(kSystemPeriodUs));
+    std::printf("%-10s %10s %10s %10s\n", "cycle on", "avg [us]", "max [us]", "delayed");
+
+    const Latency before = systemTimer(cycles, fromUs, toUs, true);
+    const Latency after = systemTimer(cycles, fromUs, toUs, false);
+    print("callback", before);
+    print("task", after);
+    return failed == 0 && after.maxUs <= before.maxUs ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+// Replays an I2C trace exported by the device (sensirion_i2c_trace.h) through
+// the unmodified driver on the host.
+//
+// A Replay attached at a bus address answers the driver's transfers with the
+// recorded status and read bytes, in recorded order, and checks that every
+// write carries the recorded bytes. Before each transfer the virtual clock is
+// moved forward to the recorded start time, so the driver sees the field
+// timing (NACK polls, sleeps, update phases) again; when the driver runs
+// behind the trace, the lag is tracked instead.
+
+#include "sen66_sim.h"
+#include "sensirion_i2c_trace.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sen66_sim {
+
+struct TraceRecord {
+    uint32_t timestampUs;
+    uint32_t durationUs;
+    uint8_t busIdx;
+    uint8_t address;
+    uint8_t dir;      // sensirion_i2c_trace_dir_t
+    int8_t status;
+    uint8_t count;
+    std::vector<uint8_t> data;
+};
+
+struct Trace {
+    uint32_t dropped = 0;
+    std::vector<TraceRecord> records;
+};
+
+// Decode an exported trace. Returns false on a bad header or a truncated
+// record; records decoded up to that point are kept.
+bool parseTrace(const uint8_t *bytes, size_t size, Trace &out);
+bool loadTrace(const char *path, Trace &out);
+
+class Replay : public Target {
+public:
+    // Serves the records of trace addressed to busIdx/address.
+    Replay(const Trace &trace, uint8_t busIdx, uint8_t address);
+
+    int8_t write(const uint8_t *data, uint16_t count) override;
+    int8_t read(uint8_t *data, uint16_t count) override;
+
+    bool finished() const { return mNext >= mRecords.size(); }
+    size_t served() const { return mNext; }
+    size_t size() const { return mRecords.size(); }
+    // Transfers that differed from the trace in direction, length or bytes.
+    uint32_t mismatches() const { return mMismatches; }
+    // Furthest the driver fell behind the recorded start times.
+    int64_t maxLagUs() const { return mMaxLagUs; }
+
+private:
+    const TraceRecord *next(bool read, uint16_t count);
+
+    std::vector<TraceRecord> mRecords;
+    size_t mNext = 0;
+    int64_t mBaseUs = 0;            // virtual time of the first record
+    int64_t mOffsetUs = 0;          // recorded time of mRecords[mNext] since the first
+    uint32_t mMismatches = 0;
+    int64_t mMaxLagUs = 0;
+};
+
+} // namespace sen66_sim
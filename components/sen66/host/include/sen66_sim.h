@@ -0,0 +1,144 @@
+#pragma once
+
+// Simulated SEN66 for running the driver on a Linux host.
+//
+// The host HAL (sensirion_i2c_hal_host.cpp) routes every transfer to the
+// simulated device attached at that bus and address. Time is virtual: it
+// only advances in sensirion_i2c_hal_sleep_usec(), vTaskDelay() and
+// advanceUs(), so a day of 1 Hz measurements runs in well under a second.
+
+#include "sen6x_traits.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace sen66_sim {
+
+// Physical values the sensor reports at one point in time.
+struct Sample {
+    float pm1_0 = 5.0f;         // µg/m³
+    float pm2_5 = 8.0f;
+    float pm4_0 = 9.0f;
+    float pm10_0 = 10.0f;
+    float humidity = 45.0f;     // %RH
+    float temperature = 22.0f;  // °C
+    float voc_index = 100.0f;
+    float nox_index = 1.0f;
+    float co2 = 600.0f;         // ppm
+    float hcho = 20.0f;         // ppb
+};
+
+// Signal profile: sample as a function of seconds since measurement start.
+using Profile = std::function<Sample(double seconds)>;
+
+Profile constant(const Sample &sample);
+// Linear interpolation between (seconds, sample) points, held at both ends.
+Profile keyframes(std::vector<std::pair<double, Sample>> points);
+
+// Anything answering transfers at one bus address: a simulated sensor or a
+// recorded trace (sen66_replay.h). Return NO_ERROR, I2C_NACK_ERROR or
+// CRC_ERROR like the HAL functions they back.
+class Target {
+public:
+    virtual ~Target() = default;
+    virtual int8_t write(const uint8_t *data, uint16_t count) = 0;
+    virtual int8_t read(uint8_t *data, uint16_t count) = 0;
+};
+
+// The SEN6x module a Device behaves as (sen6x_traits.h): its product name,
+// its channels and its measured-values read. The device NACKs the commands
+// of channels the module lacks, and the measured-values reads of the other
+// modules.
+struct Model {
+    const char *name;
+    sen66::Command readValues;
+    const sen6x::Channel *layout;
+    size_t words;
+    bool rawValues;
+
+    template <class Traits>
+    static constexpr Model of()
+    {
+        return {Traits::kName, Traits::kReadValues, Traits::kLayout, Traits::words(), Traits::kRawValues};
+    }
+
+    bool has(sen6x::Channel channel) const;
+};
+
+class Device : public Target {
+public:
+    Device();
+
+    // A SEN66 unless set otherwise; kept across power cycles.
+    void setModel(const Model &model) { mModel = model; }
+    void setProfile(Profile profile) { mProfile = std::move(profile); }
+    // Internal update period; the real sensor's clock is not exactly 1 s.
+    void setPeriodUs(int64_t periodUs) { mPeriodUs = periodUs; }
+    // How long a command with a response NACKs reads before the response is
+    // ready; by default its descriptor's min_exec_us. Write-only commands
+    // always stay busy for their full execution time.
+    void setResponseDelayUs(int64_t delayUs) { mResponseDelayUs = delayUs; }
+    // Make the next n transfers fail with a NACK, to exercise error paths.
+    void injectNacks(uint32_t n) { mInjectedNacks = n; }
+    // Raise device status flags (sen66_device_status). They stay set until
+    // read-and-clear or a reset, like the sensor's sticky error flags.
+    void raiseStatus(uint32_t flags) { mStatus |= flags; }
+    // Cut and restore power: idle, every volatile setting back to default.
+    // The signal profile is kept.
+    void powerCycle();
+
+    int8_t write(const uint8_t *data, uint16_t count) override;
+    int8_t read(uint8_t *data, uint16_t count) override;
+
+    bool measuring() const { return mMeasuring; }
+    uint32_t commands() const { return mCommands; }
+    uint32_t nacks() const { return mNacks; }
+
+private:
+    void reset();
+    bool supports(uint16_t opcode, uint8_t numArgs) const;
+    uint64_t updatesAt(int64_t nowUs) const;
+    void respond(uint16_t opcode, uint8_t rxWords, const uint16_t *args, uint8_t numArgs);
+    void pushWord(uint16_t word);
+    void pushBytes(const uint8_t *bytes, uint16_t count);
+
+    Model mModel = Model::of<sen6x::Sen66>();
+    Profile mProfile;
+    int64_t mPeriodUs = 1000 * 1000;
+    int64_t mResponseDelayUs = -1;    // < 0: min_exec_us of the command
+    bool mMeasuring = false;
+    uint32_t mStatus = 0;
+    int64_t mMeasureStartUs = 0;
+    uint64_t mUpdatesRead = 0;        // updates consumed by reading the values
+    int64_t mBusyUntilUs = 0;         // NACK everything until then
+    std::vector<uint8_t> mResponse;   // pending response frame with CRCs
+    std::map<uint16_t, std::vector<uint16_t>> mParameters; // last set words per opcode
+    uint32_t mInjectedNacks = 0;
+    uint32_t mCommands = 0;
+    uint32_t mNacks = 0;
+};
+
+// Attach a target to the host HAL; it must outlive the attachment.
+void attach(uint8_t busIdx, uint8_t address, Target *target);
+void detachAll();
+
+// Virtual clock shared by the host HAL and the ESP-IDF shims.
+int64_t nowUs();
+void advanceUs(int64_t us);
+
+// CPU time of the driver's waits, split the way the ESP-IDF HAL spends it:
+// whole scheduler ticks are yielded in vTaskDelay(), the sub-tick remainder
+// of sensirion_i2c_hal_sleep_usec() is busy-waited.
+struct WaitTotals {
+    uint64_t yieldedUs = 0;
+    uint64_t busyUs = 0;
+};
+WaitTotals waitTotals();
+void resetWaitTotals();
+// Advance the clock for time yielded to other tasks (vTaskDelay()).
+void yieldUs(int64_t us);
+
+} // namespace sen66_sim
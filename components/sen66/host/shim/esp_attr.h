@@ -0,0 +1,4 @@
+#pragma once
+// Host stand-in: RTC memory is ordinary static storage, so it "survives"
+// a simulated restart within the same process.
+#define RTC_NOINIT_ATTR
@@ -0,0 +1,13 @@
+#pragma once
+// Host stand-in for the capability allocator. There is no PSRAM, so SPIRAM
+// requests fail the way they do on a board without it.
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+
+static inline void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? NULL : calloc(n, size);
+}
@@ -0,0 +1,13 @@
+#pragma once
+// Host stand-in: esp_timer_get_time() reads the simulation's virtual clock.
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+// Host stand-in: vTaskDelay() advances the simulation's virtual clock.
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void vTaskDelay(TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+// Host stand-in for the generated configuration: the Kconfig defaults of the
+// options the compiled driver sources read.
+#define CONFIG_SEN66_VOC_STATE_NVS_INTERVAL_MIN 60
+
+// Off by default on the device. The host HAL records every transfer, so a
+// trace can be captured from the simulator and replayed (sen66_replay.h).
+#define CONFIG_SEN66_I2C_TRACE 1
+#define CONFIG_SEN66_I2C_TRACE_ENTRIES 4096
@@ -0,0 +1,93 @@
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include "sen66_sim.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+int64_t esp_timer_get_time(void)
+{
+    return sen66_sim::nowUs();
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    sen66_sim::yieldUs(static_cast<int64_t>(ticks) * portTICK_PERIOD_MS * 1000);
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+// Handles are indices into the namespace names; values are keyed by
+// "namespace/key".
+static std::vector<std::string> nvsNamespaces;
+static std::map<std::string, std::vector<uint8_t>> nvsValues;
+
+static std::string nvsKey(nvs_handle_t handle, const char *key)
+{
+    return nvsNamespaces.at(handle) + "/" + key;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t, nvs_handle_t *out_handle)
+{
+    size_t index = 0;
+    while (index < nvsNamespaces.size() && nvsNamespaces[index] != name)
+        index++;
+    if (index == nvsNamespaces.size())
+        nvsNamespaces.push_back(name);
+    *out_handle = static_cast<nvs_handle_t>(index);
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t)
+{
+}
+
+esp_err_t nvs_commit(nvs_handle_t)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    auto it = nvsValues.find(nvsKey(handle, key));
+    if (it == nvsValues.end())
+        return ESP_ERR_NVS_NOT_FOUND;
+    if (out_value != nullptr) {
+        if (*length < it->second.size())
+            return ESP_ERR_NVS_INVALID_LENGTH;
+        std::memcpy(out_value, it->second.data(), it->second.size());
+    }
+    *length = it->second.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(value);
+    nvsValues[nvsKey(handle, key)].assign(bytes, bytes + length);
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    size_t length = sizeof(*out_value);
+    return nvs_get_blob(handle, key, out_value, &length);
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return nvs_set_blob(handle, key, &value, sizeof(value));
+}
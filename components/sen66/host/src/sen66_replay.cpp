@@ -0,0 +1,121 @@
+#include "sen66_replay.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace sen66_sim {
+
+bool parseTrace(const uint8_t *bytes, size_t size, Trace &out)
+{
+    sensirion_i2c_trace_file_header_t header;
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.magic != SENSIRION_I2C_TRACE_MAGIC || header.version != SENSIRION_I2C_TRACE_VERSION ||
+        header.record_size < sizeof(sensirion_i2c_trace_record_t))
+        return false;
+
+    out.dropped = header.dropped;
+    size_t pos = sizeof(header);
+    while (pos < size) {
+        sensirion_i2c_trace_record_t raw;
+        if (size - pos < header.record_size)
+            return false;
+        std::memcpy(&raw, bytes + pos, sizeof(raw));
+        pos += header.record_size;
+        if (size - pos < raw.length)
+            return false;
+
+        TraceRecord record{raw.timestamp_us, raw.duration_us, raw.bus_idx, raw.address,
+                           raw.dir, raw.status, raw.count,
+                           std::vector<uint8_t>(bytes + pos, bytes + pos + raw.length)};
+        pos += raw.length;
+        out.records.push_back(std::move(record));
+    }
+    return true;
+}
+
+bool loadTrace(const char *path, Trace &out)
+{
+    FILE *file = std::fopen(path, "rb");
+    if (file == nullptr)
+        return false;
+
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+        bytes.insert(bytes.end(), chunk, chunk + n);
+    std::fclose(file);
+    return parseTrace(bytes.data(), bytes.size(), out);
+}
+
+Replay::Replay(const Trace &trace, uint8_t busIdx, uint8_t address)
+{
+    for (const TraceRecord &record : trace.records) {
+        if (record.busIdx == busIdx && record.address == address)
+            mRecords.push_back(record);
+    }
+}
+
+const TraceRecord *Replay::next(bool read, uint16_t count)
+{
+    if (finished())
+        return nullptr;
+
+    const TraceRecord &record = mRecords[mNext];
+    const int64_t now = nowUs();
+    if (mNext == 0) {
+        mBaseUs = now;
+    } else {
+        // Unsigned difference, so the 32-bit timestamps may wrap.
+        mOffsetUs += static_cast<uint32_t>(record.timestampUs - mRecords[mNext - 1].timestampUs);
+    }
+    const int64_t due = mBaseUs + mOffsetUs;
+    if (due > now)
+        advanceUs(due - now);
+    else if (now - due > mMaxLagUs)
+        mMaxLagUs = now - due;
+    mNext++;
+
+    const bool recordedRead = record.dir != SENSIRION_I2C_TRACE_WRITE;
+    if (recordedRead != read || record.count != count) {
+        if (mMismatches++ == 0)
+            std::fprintf(stderr, "replay: transfer %zu is a %u byte %s, trace has a %u byte %s\n",
+                         mNext - 1, count, read ? "read" : "write", record.count,
+                         recordedRead ? "read" : "write");
+    }
+    return &record;
+}
+
+int8_t Replay::write(const uint8_t *data, uint16_t count)
+{
+    const TraceRecord *record = next(false, count);
+    if (record == nullptr)
+        return I2C_NACK_ERROR;
+
+    if (record->dir == SENSIRION_I2C_TRACE_WRITE && record->count == count &&
+        std::memcmp(record->data.data(), data, record->data.size()) != 0) {
+        if (mMismatches++ == 0)
+            std::fprintf(stderr, "replay: transfer %zu writes other bytes than recorded\n", mNext - 1);
+    }
+    return record->status;
+}
+
+int8_t Replay::read(uint8_t *data, uint16_t count)
+{
+    const TraceRecord *record = next(true, count);
+    if (record == nullptr || record->dir == SENSIRION_I2C_TRACE_WRITE)
+        return I2C_NACK_ERROR;
+
+    if (record->status == NO_ERROR) {
+        std::memset(data, 0xFF, count);
+        std::memcpy(data, record->data.data(), std::min<size_t>(count, record->data.size()));
+    }
+    return record->status;
+}
+
+} // namespace sen66_sim
@@ -0,0 +1,343 @@
+#include "sen66_sim.h"
+#include "sen66_commands.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sen66_sim {
+
+namespace {
+
+constexpr uint16_t INVALID_UINT16 = 0xFFFF;
+constexpr uint16_t INVALID_INT16 = 0x7FFF;
+
+const sen66::Command *findCommand(uint16_t opcode, uint8_t txWords)
+{
+    for (const sen66::Command *c : sen66::kCommands) {
+        if (c->opcode == opcode && c->tx_words == txWords)
+            return c;
+    }
+    return nullptr;
+}
+
+// Commands the sensor only accepts in idle mode; it NACKs them while measuring.
+bool idleOnly(uint16_t opcode, uint8_t txWords)
+{
+    switch (opcode) {
+    case SEN66_START_CONTINUOUS_MEASUREMENT_CMD_ID:
+    case SEN66_START_FAN_CLEANING_CMD_ID:
+    case SEN66_SET_VOC_ALGORITHM_TUNING_PARAMETERS_CMD_ID:
+    case SEN66_SET_NOX_ALGORITHM_TUNING_PARAMETERS_CMD_ID:
+    case SEN66_PERFORM_FORCED_CO2_RECALIBRATION_CMD_ID:
+    case SEN66_SET_CO2_SENSOR_AUTOMATIC_SELF_CALIBRATION_CMD_ID:
+    case SEN66_SET_SENSOR_ALTITUDE_CMD_ID:
+        return true; // get and set alike
+    case SEN66_SET_VOC_ALGORITHM_STATE_CMD_ID:
+        return txWords > 0;
+    default:
+        return false;
+    }
+}
+
+float valueOf(const Sample &s, sen6x::Channel channel)
+{
+    switch (channel) {
+    case sen6x::PM1_0:       return s.pm1_0;
+    case sen6x::PM2_5:       return s.pm2_5;
+    case sen6x::PM4_0:       return s.pm4_0;
+    case sen6x::PM10_0:      return s.pm10_0;
+    case sen6x::HUMIDITY:    return s.humidity;
+    case sen6x::TEMPERATURE: return s.temperature;
+    case sen6x::VOC_INDEX:   return s.voc_index;
+    case sen6x::NOX_INDEX:   return s.nox_index;
+    case sen6x::CO2:         return s.co2;
+    case sen6x::HCHO:        return s.hcho;
+    }
+    return 0.0f;
+}
+
+uint16_t scaled(float value, float scale)
+{
+    return static_cast<uint16_t>(std::lround(std::max(0.0f, value) * scale));
+}
+
+uint16_t scaledSigned(float value, float scale)
+{
+    return static_cast<uint16_t>(static_cast<int16_t>(std::lround(value * scale)));
+}
+
+Sample lerp(const Sample &a, const Sample &b, float t)
+{
+    auto mix = [t](float x, float y) { return x + (y - x) * t; };
+    Sample s;
+    s.pm1_0 = mix(a.pm1_0, b.pm1_0);
+    s.pm2_5 = mix(a.pm2_5, b.pm2_5);
+    s.pm4_0 = mix(a.pm4_0, b.pm4_0);
+    s.pm10_0 = mix(a.pm10_0, b.pm10_0);
+    s.humidity = mix(a.humidity, b.humidity);
+    s.temperature = mix(a.temperature, b.temperature);
+    s.voc_index = mix(a.voc_index, b.voc_index);
+    s.nox_index = mix(a.nox_index, b.nox_index);
+    s.co2 = mix(a.co2, b.co2);
+    s.hcho = mix(a.hcho, b.hcho);
+    return s;
+}
+
+} // namespace
+
+Profile constant(const Sample &sample)
+{
+    return [sample](double) { return sample; };
+}
+
+Profile keyframes(std::vector<std::pair<double, Sample>> points)
+{
+    std::sort(points.begin(), points.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+    return [points](double seconds) {
+        if (points.empty())
+            return Sample{};
+        if (seconds <= points.front().first)
+            return points.front().second;
+        for (size_t i = 1; i < points.size(); i++) {
+            if (seconds <= points[i].first) {
+                const auto &a = points[i - 1];
+                const auto &b = points[i];
+                return lerp(a.second, b.second,
+                            static_cast<float>((seconds - a.first) / (b.first - a.first)));
+            }
+        }
+        return points.back().second;
+    };
+}
+
+bool Model::has(sen6x::Channel channel) const
+{
+    for (size_t w = 0; w < words; w++) {
+        if (layout[w] == channel)
+            return true;
+    }
+    return false;
+}
+
+Device::Device()
+{
+    reset();
+}
+
+void Device::reset()
+{
+    mProfile = constant(Sample{});
+    mMeasuring = false;
+    mStatus = 0;
+    mUpdatesRead = 0;
+    mResponse.clear();
+    mParameters.clear();
+    mParameters[SEN66_GET_AMBIENT_PRESSURE_CMD_ID] = {1013};
+    mParameters[SEN66_GET_CO2_SENSOR_AUTOMATIC_SELF_CALIBRATION_CMD_ID] = {0x0001};
+    mParameters[SEN66_GET_VOC_ALGORITHM_TUNING_PARAMETERS_CMD_ID] = {100, 12, 12, 180, 50, 230};
+    mParameters[SEN66_GET_NOX_ALGORITHM_TUNING_PARAMETERS_CMD_ID] = {1, 12, 12, 720, 50, 230};
+}
+
+void Device::powerCycle()
+{
+    Profile profile = std::move(mProfile);
+    reset();
+    mProfile = std::move(profile);
+}
+
+bool Device::supports(uint16_t opcode, uint8_t numArgs) const
+{
+    if (opcode == mModel.readValues.opcode)
+        return numArgs == 0;
+    switch (opcode) {
+    case SEN66_READ_MEASURED_VALUES_AS_INTEGERS_CMD_ID:
+        return false; // another module's read
+    case SEN66_READ_MEASURED_RAW_VALUES_CMD_ID:
+        return mModel.rawValues;
+    case SEN66_PERFORM_FORCED_CO2_RECALIBRATION_CMD_ID:
+    case SEN66_SET_CO2_SENSOR_AUTOMATIC_SELF_CALIBRATION_CMD_ID:
+    case SEN66_SET_AMBIENT_PRESSURE_CMD_ID:
+    case SEN66_SET_SENSOR_ALTITUDE_CMD_ID:
+        return mModel.has(sen6x::CO2);
+    case SEN66_SET_VOC_ALGORITHM_TUNING_PARAMETERS_CMD_ID:
+    case SEN66_SET_VOC_ALGORITHM_STATE_CMD_ID:
+        return mModel.has(sen6x::VOC_INDEX);
+    case SEN66_SET_NOX_ALGORITHM_TUNING_PARAMETERS_CMD_ID:
+        return mModel.has(sen6x::NOX_INDEX);
+    default:
+        return true;
+    }
+}
+
+uint64_t Device::updatesAt(int64_t nowUs) const
+{
+    if (!mMeasuring || nowUs < mMeasureStartUs)
+        return 0;
+    return static_cast<uint64_t>((nowUs - mMeasureStartUs) / mPeriodUs);
+}
+
+void Device::pushWord(uint16_t word)
+{
+    uint8_t bytes[2] = {static_cast<uint8_t>(word >> 8), static_cast<uint8_t>(word)};
+    mResponse.push_back(bytes[0]);
+    mResponse.push_back(bytes[1]);
+    mResponse.push_back(sensirion_i2c_generate_crc(bytes, 2));
+}
+
+void Device::pushBytes(const uint8_t *bytes, uint16_t count)
+{
+    for (uint16_t i = 0; i + 1 < count; i += 2)
+        pushWord(static_cast<uint16_t>(bytes[i] << 8 | bytes[i + 1]));
+}
+
+int8_t Device::write(const uint8_t *data, uint16_t count)
+{
+    const int64_t now = nowUs();
+
+    if (mInjectedNacks > 0 || now < mBusyUntilUs || count < 2 ||
+        (count - 2) % (SENSIRION_WORD_SIZE + CRC8_LEN) != 0) {
+        if (mInjectedNacks > 0)
+            mInjectedNacks--;
+        mNacks++;
+        return I2C_NACK_ERROR;
+    }
+
+    uint16_t opcode = static_cast<uint16_t>(data[0] << 8 | data[1]);
+    uint16_t args[SEN66_COMMUNICATION_BUFFER_SIZE / 3];
+    uint8_t numArgs = static_cast<uint8_t>((count - 2) / 3);
+    for (uint8_t i = 0; i < numArgs; i++) {
+        const uint8_t *word = &data[2 + i * 3];
+        if (sensirion_i2c_generate_crc(word, 2) != word[2]) {
+            mNacks++;
+            return CRC_ERROR;
+        }
+        args[i] = static_cast<uint16_t>(word[0] << 8 | word[1]);
+    }
+
+    const sen66::Command *command =
+        opcode == mModel.readValues.opcode ? &mModel.readValues : findCommand(opcode, numArgs);
+    if (command == nullptr || !supports(opcode, numArgs) || (mMeasuring && idleOnly(opcode, numArgs))) {
+        mNacks++;
+        return I2C_NACK_ERROR;
+    }
+
+    // Real units answer reads well within the documented worst case, so a
+    // response is ready after the minimum execution time unless a delay is
+    // set; write-only commands keep the device busy for the full time.
+    mCommands++;
+    mResponse.clear();
+    if (command->rx_words == 0)
+        mBusyUntilUs = now + command->exec_time_us;
+    else
+        mBusyUntilUs = now + (mResponseDelayUs >= 0 ? mResponseDelayUs : command->min_exec_us);
+    respond(opcode, command->rx_words, args, numArgs);
+    return NO_ERROR;
+}
+
+void Device::respond(uint16_t opcode, uint8_t rxWords, const uint16_t *args, uint8_t numArgs)
+{
+    const int64_t now = nowUs();
+    const uint64_t updates = updatesAt(now);
+    const Sample sample = mProfile(static_cast<double>(updates) * mPeriodUs / 1e6);
+    const bool valid = updates > 0;
+
+    if (opcode == mModel.readValues.opcode) {
+        mUpdatesRead = updates;
+        for (size_t w = 0; w < mModel.words; w++) {
+            const sen6x::Channel channel = mModel.layout[w];
+            if (!valid)
+                pushWord(sen6x::isSigned(channel) ? INVALID_INT16 : INVALID_UINT16);
+            else if (sen6x::isSigned(channel))
+                pushWord(scaledSigned(valueOf(sample, channel), sen6x::scale(channel)));
+            else
+                pushWord(scaled(valueOf(sample, channel), sen6x::scale(channel)));
+        }
+        return;
+    }
+
+    switch (opcode) {
+    case SEN66_START_CONTINUOUS_MEASUREMENT_CMD_ID:
+        mMeasuring = true;
+        mMeasureStartUs = now;
+        mUpdatesRead = 0;
+        return;
+    case SEN66_STOP_MEASUREMENT_CMD_ID:
+        mMeasuring = false;
+        return;
+    case SEN66_DEVICE_RESET_CMD_ID:
+        reset();
+        return;
+    case SEN66_GET_DATA_READY_CMD_ID:
+        pushWord(updates > mUpdatesRead ? 0x0001 : 0x0000);
+        return;
+    case SEN66_READ_NUMBER_CONCENTRATION_VALUES_AS_INTEGERS_CMD_ID:
+        // Rough mass-to-count conversion, enough for plausible frames.
+        pushWord(valid ? scaled(sample.pm1_0 * 5.0f, 10) : INVALID_UINT16);
+        pushWord(valid ? scaled(sample.pm1_0 * 6.0f, 10) : INVALID_UINT16);
+        pushWord(valid ? scaled(sample.pm2_5 * 6.2f, 10) : INVALID_UINT16);
+        pushWord(valid ? scaled(sample.pm4_0 * 6.3f, 10) : INVALID_UINT16);
+        pushWord(valid ? scaled(sample.pm10_0 * 6.3f, 10) : INVALID_UINT16);
+        return;
+    case SEN66_READ_MEASURED_RAW_VALUES_CMD_ID:
+        pushWord(valid ? scaledSigned(sample.humidity, 100) : INVALID_INT16);
+        pushWord(valid ? scaledSigned(sample.temperature, 200) : INVALID_INT16);
+        pushWord(valid ? scaled(30000.0f - sample.voc_index * 20.0f, 1) : INVALID_UINT16);
+        pushWord(valid ? scaled(15000.0f + sample.nox_index * 50.0f, 1) : INVALID_UINT16);
+        pushWord(valid ? scaled(sample.co2, 1) : INVALID_UINT16);
+        return;
+    case SEN66_PERFORM_FORCED_CO2_RECALIBRATION_CMD_ID:
+        pushWord(0x8000); // correction of 0 ppm
+        return;
+    case SEN66_GET_PRODUCT_NAME_CMD_ID:
+    case SEN66_GET_SERIAL_NUMBER_CMD_ID: {
+        uint8_t text[32] = {0};
+        const char *s = opcode == SEN66_GET_PRODUCT_NAME_CMD_ID ? mModel.name : "SIM0000000000001";
+        std::memcpy(text, s, std::strlen(s));
+        pushBytes(text, sizeof(text));
+        return;
+    }
+    case SEN66_GET_VERSION_CMD_ID:
+        pushWord(0x0400);
+        return;
+    case SEN66_READ_DEVICE_STATUS_CMD_ID:
+    case SEN66_READ_AND_CLEAR_DEVICE_STATUS_CMD_ID:
+        pushWord(static_cast<uint16_t>(mStatus >> 16));
+        pushWord(static_cast<uint16_t>(mStatus));
+        if (opcode == SEN66_READ_AND_CLEAR_DEVICE_STATUS_CMD_ID)
+            mStatus = 0;
+        return;
+    default:
+        break;
+    }
+
+    // Plain parameters: a set stores the words, the matching get returns them.
+    if (numArgs > 0) {
+        mParameters[opcode].assign(args, args + numArgs);
+        return;
+    }
+    const std::vector<uint16_t> &stored = mParameters[opcode];
+    for (uint8_t i = 0; i < rxWords; i++)
+        pushWord(i < stored.size() ? stored[i] : 0);
+}
+
+int8_t Device::read(uint8_t *data, uint16_t count)
+{
+    if (mInjectedNacks > 0 || nowUs() < mBusyUntilUs || mResponse.empty()) {
+        if (mInjectedNacks > 0)
+            mInjectedNacks--;
+        mNacks++;
+        return I2C_NACK_ERROR;
+    }
+
+    // Reading past the response clocks in 0xFF, as on the real bus.
+    for (uint16_t i = 0; i < count; i++)
+        data[i] = i < mResponse.size() ? mResponse[i] : 0xFF;
+    mResponse.clear();
+    return NO_ERROR;
+}
+
+} // namespace sen66_sim
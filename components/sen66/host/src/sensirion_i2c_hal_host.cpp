@@ -0,0 +1,350 @@
+// Linux implementation of sensirion_i2c_hal.h. Transfers go to the targets
+// (simulated devices or trace replays) attached with sen66_sim::attach(); a
+// transfer to any other address is NACKed. Each transfer advances the virtual clock by its duration on a
+// 100 kHz bus, and the retry behaviour mirrors the ESP-IDF HAL. Every transfer is recorded
+// (sensirion_i2c_trace.h), so a simulated session exports as a replayable trace.
+
+#include "sensirion_i2c_hal.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+#include "sensirion_i2c_trace.h"
+#include "sen66_sim.h"
+#include "freertos/task.h"
+
+#include <cstdio>
+#include <map>
+
+struct sensirion_i2c_hal_device {
+    uint8_t bus_idx;
+    uint8_t address;
+    uint16_t last_opcode;
+    sensirion_i2c_hal_device_stats_t bus_stats;
+};
+
+namespace {
+
+constexpr int64_t BYTE_TIME_US = 90;     // 9 clocks at 100 kHz
+constexpr uint8_t MAX_RETRIES = 3;       // CONFIG_SEN66_I2C_MAX_RETRIES default
+constexpr uint32_t BACKOFF_BASE_US = 1000;
+
+int64_t clock_us = 0;
+bool bus_up[SENSIRION_I2C_HAL_MAX_BUSES];
+uint8_t selected_bus = 0;
+std::map<uint16_t, sensirion_i2c_hal_device> devices;
+std::map<uint16_t, sen66_sim::Target *> attached;
+sensirion_i2c_hal_stats_t stats;
+// Transfers run one at a time, so the bus is never contended here; only
+// grants and busy time are counted.
+sensirion_i2c_hal_bus_stats_t bus_stats[SENSIRION_I2C_HAL_MAX_BUSES];
+sensirion_i2c_hal_profile_t profile; // always on; the clock is virtual anyway
+uint64_t profile_bus_us;
+sen66_sim::WaitTotals wait_totals;
+
+uint16_t key(uint8_t bus_idx, uint8_t address)
+{
+    return static_cast<uint16_t>(bus_idx << 8 | address);
+}
+
+uint8_t bucket(int64_t us)
+{
+    uint8_t b = 0;
+    while (b + 1 < SENSIRION_I2C_HAL_PROFILE_BUCKETS && us >= (int64_t{2} << b))
+        b++;
+    return b;
+}
+
+void profile_transaction(sensirion_i2c_hal_device_t *dev, bool read, const uint8_t *data, uint8_t count,
+                         int8_t status, int64_t duration_us)
+{
+    if (!read && count >= 2)
+        dev->last_opcode = static_cast<uint16_t>(data[0] << 8 | data[1]);
+
+    profile_bus_us += duration_us;
+    sensirion_i2c_hal_opcode_profile_t *entry = nullptr;
+    for (uint8_t i = 0; i < profile.opcode_count && entry == nullptr; i++) {
+        if (profile.opcodes[i].opcode == dev->last_opcode)
+            entry = &profile.opcodes[i];
+    }
+    if (entry == nullptr && profile.opcode_count < SENSIRION_I2C_HAL_PROFILE_OPCODES) {
+        entry = &profile.opcodes[profile.opcode_count++];
+        entry->opcode = dev->last_opcode;
+    }
+    if (entry == nullptr) {
+        profile.untracked++;
+        return;
+    }
+    entry->transactions++;
+    if (status != NO_ERROR)
+        entry->errors++;
+    if (!read)
+        entry->tx_bytes += count;
+    else if (status == NO_ERROR)
+        entry->rx_bytes += count;
+    entry->bus_us += duration_us;
+    entry->latency[bucket(duration_us)]++;
+}
+
+int8_t transfer_once(sensirion_i2c_hal_device_t *dev, uint8_t *rx, const uint8_t *tx,
+                     uint8_t count, bool polling)
+{
+    auto it = attached.find(key(dev->bus_idx, dev->address));
+    const int64_t start_us = clock_us;
+    int8_t status;
+
+    // Address byte plus payload; a NACKed address ends the transfer early.
+    clock_us += BYTE_TIME_US;
+    if (it == attached.end()) {
+        status = I2C_NACK_ERROR;
+    } else {
+        status = rx != nullptr ? it->second->read(rx, count) : it->second->write(tx, count);
+        if (status == NO_ERROR)
+            clock_us += BYTE_TIME_US * count;
+    }
+
+    bus_stats[dev->bus_idx].transactions++;
+    bus_stats[dev->bus_idx].busy_us += clock_us - start_us;
+    if (clock_us - start_us > bus_stats[dev->bus_idx].max_hold_us)
+        bus_stats[dev->bus_idx].max_hold_us = static_cast<uint32_t>(clock_us - start_us);
+    dev->bus_stats.transactions++;
+
+    if (status == I2C_NACK_ERROR) {
+        if (polling)
+            stats.poll_nacks++;
+        else
+            stats.nack_errors++;
+    }
+    profile_transaction(dev, rx != nullptr, rx != nullptr ? rx : tx, count, status, clock_us - start_us);
+
+    const sensirion_i2c_trace_dir_t dir = rx == nullptr ? SENSIRION_I2C_TRACE_WRITE
+                                          : polling     ? SENSIRION_I2C_TRACE_POLL_READ
+                                                        : SENSIRION_I2C_TRACE_READ;
+    sensirion_i2c_trace_record(dev->bus_idx, dev->address, dir, rx != nullptr ? rx : tx, count, status,
+                               static_cast<uint32_t>(start_us), static_cast<uint32_t>(clock_us - start_us));
+    return status;
+}
+
+int8_t transfer(sensirion_i2c_hal_device_t *dev, uint8_t *rx, const uint8_t *tx, uint8_t count)
+{
+    if (dev == nullptr)
+        return I2C_BUS_ERROR;
+
+    int8_t status;
+    for (uint8_t attempt = 0;; attempt++) {
+        status = transfer_once(dev, rx, tx, count, false);
+        if (status == NO_ERROR || attempt >= MAX_RETRIES)
+            break;
+        stats.retries++;
+        sensirion_i2c_hal_sleep_usec(BACKOFF_BASE_US << attempt);
+    }
+    return status;
+}
+
+} // namespace
+
+namespace sen66_sim {
+
+void attach(uint8_t busIdx, uint8_t address, Target *target)
+{
+    attached[key(busIdx, address)] = target;
+}
+
+void detachAll()
+{
+    attached.clear();
+}
+
+int64_t nowUs()
+{
+    return clock_us;
+}
+
+void advanceUs(int64_t us)
+{
+    clock_us += us;
+}
+
+WaitTotals waitTotals()
+{
+    return wait_totals;
+}
+
+void resetWaitTotals()
+{
+    wait_totals = {};
+}
+
+void yieldUs(int64_t us)
+{
+    clock_us += us;
+    wait_totals.yieldedUs += us;
+}
+
+} // namespace sen66_sim
+
+int16_t sensirion_i2c_hal_select_bus(uint8_t bus_idx)
+{
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES || !bus_up[bus_idx])
+        return I2C_BUS_ERROR;
+    selected_bus = bus_idx;
+    return NO_ERROR;
+}
+
+void sensirion_i2c_hal_init(void)
+{
+    sensirion_i2c_trace_init();
+    for (uint8_t i = 0; i < SENSIRION_I2C_HAL_MAX_BUSES; i++) {
+        bus_up[i] = true;
+        sensirion_i2c_hal_reset_bus_stats(i);
+    }
+}
+
+int16_t sensirion_i2c_hal_init_bus(uint8_t bus_idx, const sensirion_i2c_hal_bus_config_t *config)
+{
+    (void)config;
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES)
+        return I2C_BUS_ERROR;
+    bus_up[bus_idx] = true;
+    sensirion_i2c_hal_reset_bus_stats(bus_idx);
+    return NO_ERROR;
+}
+
+void sensirion_i2c_hal_free(void)
+{
+    devices.clear();
+    for (uint8_t i = 0; i < SENSIRION_I2C_HAL_MAX_BUSES; i++)
+        bus_up[i] = false;
+    selected_bus = 0;
+}
+
+sensirion_i2c_hal_device_t *sensirion_i2c_hal_get_device(uint8_t bus_idx, uint8_t address)
+{
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES || !bus_up[bus_idx])
+        return nullptr;
+    auto it = devices.emplace(key(bus_idx, address), sensirion_i2c_hal_device{bus_idx, address, 0, {}}).first;
+    return &it->second;
+}
+
+int8_t sensirion_i2c_hal_read(uint8_t address, uint8_t *data, uint8_t count)
+{
+    return sensirion_i2c_hal_device_read(sensirion_i2c_hal_get_device(selected_bus, address), data, count);
+}
+
+int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t *data, uint8_t count)
+{
+    return sensirion_i2c_hal_device_write(sensirion_i2c_hal_get_device(selected_bus, address), data, count);
+}
+
+int8_t sensirion_i2c_hal_device_read(sensirion_i2c_hal_device_t *dev, uint8_t *data, uint8_t count)
+{
+    return transfer(dev, data, nullptr, count);
+}
+
+int8_t sensirion_i2c_hal_device_write(sensirion_i2c_hal_device_t *dev, const uint8_t *data, uint8_t count)
+{
+    return transfer(dev, nullptr, data, count);
+}
+
+// Two transfers here; the targets only model plain reads and writes.
+int8_t sensirion_i2c_hal_device_write_read(sensirion_i2c_hal_device_t *dev, const uint8_t *tx, uint8_t tx_count,
+                                           uint8_t *rx, uint8_t rx_count)
+{
+    int8_t status = transfer(dev, nullptr, tx, tx_count);
+    return status == NO_ERROR ? transfer(dev, rx, nullptr, rx_count) : status;
+}
+
+int8_t sensirion_i2c_hal_device_poll_read(sensirion_i2c_hal_device_t *dev, uint8_t *data, uint8_t count)
+{
+    if (dev == nullptr)
+        return I2C_BUS_ERROR;
+    return transfer_once(dev, data, nullptr, count, true);
+}
+
+int16_t sensirion_i2c_hal_recover(sensirion_i2c_hal_device_t *dev)
+{
+    if (dev == nullptr)
+        return I2C_BUS_ERROR;
+    stats.bus_resets++;
+    stats.device_readds++;
+    return NO_ERROR;
+}
+
+void sensirion_i2c_hal_get_stats(sensirion_i2c_hal_stats_t *out)
+{
+    *out = stats;
+}
+
+int16_t sensirion_i2c_hal_get_bus_stats(uint8_t bus_idx, sensirion_i2c_hal_bus_stats_t *out)
+{
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES || !bus_up[bus_idx])
+        return I2C_BUS_ERROR;
+    *out = bus_stats[bus_idx];
+    return NO_ERROR;
+}
+
+void sensirion_i2c_hal_reset_bus_stats(uint8_t bus_idx)
+{
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES)
+        return;
+    bus_stats[bus_idx] = {};
+    bus_stats[bus_idx].since_us = clock_us;
+}
+
+void sensirion_i2c_hal_get_device_stats(const sensirion_i2c_hal_device_t *dev,
+                                        sensirion_i2c_hal_device_stats_t *out)
+{
+    *out = dev != nullptr ? dev->bus_stats : sensirion_i2c_hal_device_stats_t{};
+}
+
+void sensirion_i2c_hal_log_bus_stats(void)
+{
+    for (uint8_t i = 0; i < SENSIRION_I2C_HAL_MAX_BUSES; i++) {
+        const sensirion_i2c_hal_bus_stats_t &s = bus_stats[i];
+        const int64_t span_us = clock_us - s.since_us;
+        if (!bus_up[i])
+            continue;
+        std::fprintf(stderr, "bus %u: %.2f%% busy, %u tx, max hold %u us\n", i,
+                     span_us > 0 ? 100.0 * static_cast<double>(s.busy_us) / static_cast<double>(span_us) : 0.0,
+                     s.transactions, s.max_hold_us);
+    }
+}
+
+void sensirion_i2c_hal_get_profile(sensirion_i2c_hal_profile_t *out)
+{
+    *out = profile;
+}
+
+void sensirion_i2c_hal_get_time_totals(uint64_t *bus_us, uint64_t *sleep_us)
+{
+    *bus_us = profile_bus_us;
+    *sleep_us = profile.sleep_us;
+}
+
+void sensirion_i2c_hal_reset_profile(void)
+{
+    profile = {};
+    profile_bus_us = 0;
+}
+
+void sensirion_i2c_hal_log_profile(void)
+{
+    for (uint8_t i = 0; i < profile.opcode_count; i++) {
+        const sensirion_i2c_hal_opcode_profile_t &p = profile.opcodes[i];
+        std::fprintf(stderr, "0x%04x: %u tx, %u err, %u/%u B, bus %llu us\n", p.opcode, p.transactions,
+                     p.errors, p.tx_bytes, p.rx_bytes, static_cast<unsigned long long>(p.bus_us));
+    }
+    std::fprintf(stderr, "sleep: %u calls, %llu us; %u untracked tx\n", profile.sleeps,
+                 static_cast<unsigned long long>(profile.sleep_us), profile.untracked);
+}
+
+// Same split as the ESP-IDF HAL: whole ticks in vTaskDelay(), the rest
+// busy-waited. The virtual tick never returns early, so one delay suffices.
+void sensirion_i2c_hal_sleep_usec(uint32_t useconds)
+{
+    const uint32_t tick_us = portTICK_PERIOD_MS * 1000;
+    vTaskDelay(useconds / tick_us);
+    clock_us += useconds % tick_us;
+    wait_totals.busyUs += useconds % tick_us;
+    profile.sleeps++;
+    profile.sleep_us += useconds;
+    profile.sleep_latency[bucket(useconds)]++;
+}
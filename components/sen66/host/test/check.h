@@ -0,0 +1,39 @@
+#pragma once
+
+// Assertions for the host tests. A failing CHECK prints the expression and
+// carries on, so one run reports every failure; main() returns
+// test::result() for ctest.
+
+#include <cstdio>
+
+namespace test {
+
+inline int failures = 0;
+
+inline int result()
+{
+    if (failures != 0)
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace test
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            test::failures++;                                                           \
+        }                                                                               \
+    } while (0)
+
+// Floating-point comparison within an absolute tolerance.
+#define CHECK_NEAR(actual, expected, tolerance)                                            \
+    do {                                                                                   \
+        const double a_ = (actual), e_ = (expected);                                       \
+        if (a_ < e_ - (tolerance) || a_ > e_ + (tolerance)) {                              \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR(%s) failed: %g, expected %g\n", __FILE__, \
+                         __LINE__, #actual, a_, e_);                                       \
+            test::failures++;                                                              \
+        }                                                                                  \
+    } while (0)
@@ -0,0 +1,27 @@
+#pragma once
+
+// Phase-locked measurement cycles for the host tests, paced the way
+// SensorTask paces them: one cycle per measurement interval, read at the
+// time the phase lock picks for it.
+
+#include "sen66_sensor.h"
+#include "sen66_sim.h"
+
+#include <cstdint>
+
+namespace test {
+
+constexpr int64_t kIntervalUs = 5 * 1000 * 1000;
+
+// Sleep until the phase lock's read time for the cycle after due, then
+// measure with the default context. Advances due by one interval.
+inline bool measureAt(int64_t &due, Sen66PhaseLock &lock, sen66_data_t *data)
+{
+    due += kIntervalUs;
+    const int64_t at = lock.nextReadUs(due);
+    if (at > sen66_sim::nowUs())
+        sen66_sim::advanceUs(at - sen66_sim::nowUs());
+    return sen66_get_measurement(sen66_default_ctx(), lock, data);
+}
+
+} // namespace test
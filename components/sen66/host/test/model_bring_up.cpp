@@ -0,0 +1,85 @@
+// Bring-up and measurement of the driver built for one of the other SEN6x
+// modules (sen66_model_test in CMakeLists.txt) against a simulated device of
+// that module, which NACKs the commands of the channels it lacks.
+
+#include "check.h"
+#include "measure.h"
+#include "sen66_sensor.h"
+#include "sen66_sim.h"
+#include "sen6x_traits.h"
+#include "sensirion_i2c_hal.h"
+
+#include <cmath>
+
+namespace {
+
+using sen6x::Active;
+
+sen66_sim::Sample steadyAir()
+{
+    sen66_sim::Sample s;
+    s.pm2_5 = 12.3f;
+    s.temperature = 21.5f;
+    s.voc_index = 104.0f;
+    s.co2 = 612.0f;
+    s.hcho = 31.0f;
+    return s;
+}
+
+// Present channels decode to the simulated value, absent ones stay NaN.
+void checkChannel(sen6x::Channel channel, float value, float expected, float tolerance)
+{
+    if (Active::has(channel))
+        CHECK_NEAR(value, expected, tolerance);
+    else
+        CHECK(std::isnan(value));
+}
+
+void checkValues(const sen66_data_t &data)
+{
+    CHECK_NEAR(data.pm2_5, 12.3, 0.05);
+    CHECK_NEAR(data.temperature, 21.5, 0.005);
+    checkChannel(sen6x::VOC_INDEX, data.voc_index, 104.0f, 0.05f);
+    checkChannel(sen6x::CO2, data.co2_equivalent, 612.0f, 0.5f);
+    checkChannel(sen6x::HCHO, data.hcho, 31.0f, 0.05f);
+}
+
+} // namespace
+
+int main()
+{
+    sen66_sim::Device device;
+    device.setModel(sen66_sim::Model::of<Active>());
+    device.setProfile(sen66_sim::constant(steadyAir()));
+    sen66_sim::attach(0, SEN66_I2C_ADDR_6B, &device);
+
+    // Settings of channels the module lacks are ignored.
+    sen66_config_t config = sen66_default_config();
+    config.altitude_m = 350;
+    config.co2_asc_enabled = false;
+    config.temperature_offset = 200; // 1 °C
+    CHECK(sen66_bring_up(&config));
+    CHECK(device.measuring());
+
+    Sen66PhaseLock lock;
+    sen66_data_t data{};
+    int64_t due = sen66_sim::nowUs();
+    CHECK(test::measureAt(due, lock, &data));
+    checkValues(data);
+
+    // A warm bring-up finds the sensor measuring.
+    CHECK(sen66_bring_up(&config));
+    CHECK(device.measuring());
+    CHECK(test::measureAt(due, lock, &data));
+    checkValues(data);
+
+    // After a power cycle the sensor is idle until brought up again.
+    device.powerCycle();
+    CHECK(sen66_bring_up(&config));
+    CHECK(device.measuring());
+    Sen66PhaseLock relock;
+    CHECK(test::measureAt(due, relock, &data));
+    checkValues(data);
+
+    return test::result();
+}
@@ -0,0 +1,234 @@
+// PM spike suppression on a replayed trace.
+//
+// A simulated session is captured with the I2C recorder and exported. Short
+// spikes (insects, dust puffs) are then written into the PM words of its
+// measured-values frames, and both traces are replayed through the
+// unmodified driver. The PM values go through SensorTask's PM smoothing and
+// its 1 ug/m3 report threshold, once as the SMA-only chain it had before and
+// once with the Median<5> pre-stage it has now.
+
+#include "check.h"
+#include "measure.h"
+#include "sen66_i2c.h"
+#include "sen66_replay.h"
+#include "sen66_sensor.h"
+#include "sen66_sim.h"
+#include "sen6x_traits.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+#include "sensirion_i2c_hal.h"
+#include "sensirion_i2c_trace.h"
+
+#include <FilterChain.h>
+#include <MultiChannelSma.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr int kCycles = 600; // 50 minutes, well within the recorder's ring
+constexpr size_t kFrameBytes = sen6x::Active::words() * (SENSIRION_WORD_SIZE + CRC8_LEN);
+
+// One spike event every kEventSpacing frames, alternating between a single
+// sample and a two-sample puff. Events are further apart than the median
+// window, which sees at most two spiked samples at a time.
+constexpr int kEventSpacing = 20;
+constexpr float kSpikeUgM3 = 60.0f;
+constexpr float kPuffUgM3[] = {40.0f, 28.0f};
+
+// SensorTask's PM thresholds (kPm10Threshold, kPm25Threshold).
+constexpr float kPmThreshold = 1.0f;
+
+// A slow swing over the session with a little wobble, as indoor air drifts.
+sen66_sim::Sample drifting(double seconds)
+{
+    const float pm = 10.0f + 6.0f * std::sin(seconds * 2 * M_PI / 3000.0) + 0.4f * std::sin(seconds * 0.7);
+    sen66_sim::Sample s;
+    s.pm1_0 = 0.6f * pm;
+    s.pm2_5 = pm;
+    s.pm4_0 = 1.1f * pm;
+    s.pm10_0 = 1.2f * pm;
+    return s;
+}
+
+bool appendTo(const void *data, size_t length, void *arg)
+{
+    auto *bytes = static_cast<std::vector<uint8_t> *>(arg);
+    bytes->insert(bytes->end(), static_cast<const uint8_t *>(data), static_cast<const uint8_t *>(data) + length);
+    return true;
+}
+
+// Adds ugM3 to every PM word of a measured-values frame and fixes its CRCs.
+void spikeFrame(std::vector<uint8_t> &frame, float ugM3)
+{
+    for (size_t w = 0; w < sen6x::Active::words(); w++) {
+        const sen6x::Channel channel = sen6x::Active::kLayout[w];
+        if (channel != sen6x::PM1_0 && channel != sen6x::PM2_5 && channel != sen6x::PM4_0 &&
+            channel != sen6x::PM10_0)
+            continue;
+        uint8_t *word = &frame[w * (SENSIRION_WORD_SIZE + CRC8_LEN)];
+        const float raw = static_cast<float>(word[0] << 8 | word[1]) + ugM3 * sen6x::scale(channel);
+        const uint16_t value = static_cast<uint16_t>(std::min(raw, 65534.0f));
+        word[0] = static_cast<uint8_t>(value >> 8);
+        word[1] = static_cast<uint8_t>(value);
+        word[2] = sensirion_i2c_generate_crc(word, SENSIRION_WORD_SIZE);
+    }
+}
+
+// Writes the spike events into the measured-values frames of trace that the
+// driver keeps: those read right after data-ready was seen, not the reads
+// that only clear the flag. Returns the number of events.
+int injectSpikes(sen66_sim::Trace &trace)
+{
+    int frame = 0, events = 0;
+    uint16_t command = 0, previousCommand = 0;
+    for (sen66_sim::TraceRecord &record : trace.records) {
+        if (record.dir == SENSIRION_I2C_TRACE_WRITE) {
+            if (record.status == NO_ERROR && record.data.size() == SENSIRION_COMMAND_SIZE) {
+                previousCommand = command;
+                command = static_cast<uint16_t>(record.data[0] << 8 | record.data[1]);
+            }
+            continue;
+        }
+        if (command != SEN66_READ_MEASURED_VALUES_AS_INTEGERS_CMD_ID ||
+            previousCommand != SEN66_GET_DATA_READY_CMD_ID || record.status != NO_ERROR ||
+            record.data.size() != kFrameBytes)
+            continue;
+        command = 0;
+
+        const int event = frame / kEventSpacing, offset = frame % kEventSpacing;
+        frame++;
+        if (event == 0 || offset >= 2)
+            continue; // the first frames fill the filters
+        if (event % 2 == 1) {
+            if (offset == 0) {
+                spikeFrame(record.data, kSpikeUgM3);
+                events++;
+            }
+        } else {
+            spikeFrame(record.data, kPuffUgM3[offset]);
+            events += offset == 0;
+        }
+    }
+    return events;
+}
+
+// SensorTask's PM path from a cold start: optional per-channel Median<5>,
+// the shared 4-sample moving average, and a report whenever a channel moves
+// past its threshold from the last published value.
+class PmReports
+{
+public:
+    explicit PmReports(bool spikeFilter) : mSpikeFilter(spikeFilter) {}
+
+    void add(const sen66_data_t &data)
+    {
+        std::array<float, 3> pm = {data.pm1_0, data.pm2_5, data.pm10_0};
+        if (mSpikeFilter) {
+            for (size_t c = 0; c < pm.size(); c++)
+                pm[c] = mMedians[c].addSample(pm[c]);
+        }
+        const std::array<float, 3> &smooth = mSma.addSamples(pm);
+        for (size_t c = 0; c < smooth.size(); c++) {
+            if (std::fabs(smooth[c] - mPublished[c]) > kPmThreshold) {
+                mPublished = smooth;
+                mCount++;
+                return;
+            }
+        }
+    }
+
+    int count() const { return mCount; }
+
+private:
+    bool mSpikeFilter;
+    std::array<filters::Chain<filters::Median<5>>, 3> mMedians;
+    MultiChannelSma<3, 4> mSma;
+    std::array<float, 3> mPublished{};
+    int mCount = 0;
+};
+
+struct Replayed {
+    int samples = 0;
+    int smaOnly = 0;
+    int withMedian = 0;
+};
+
+Replayed replay(const sen66_sim::Trace &trace)
+{
+    sen66_sim::Replay replay(trace, 0, SEN66_I2C_ADDR_6B);
+    sen66_sim::attach(0, SEN66_I2C_ADDR_6B, &replay);
+
+    Sen66PhaseLock lock;
+    PmReports smaOnly(false), withMedian(true);
+    Replayed result;
+    int64_t due = sen66_sim::nowUs();
+    for (int i = 0; i < kCycles; i++) {
+        sen66_data_t data{};
+        if (!test::measureAt(due, lock, &data))
+            continue;
+        smaOnly.add(data);
+        withMedian.add(data);
+        result.samples++;
+    }
+    CHECK(replay.finished());
+    CHECK(replay.mismatches() == 0);
+    result.smaOnly = smaOnly.count();
+    result.withMedian = withMedian.count();
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    sen66_sim::Device device;
+    device.setProfile(drifting);
+    sen66_sim::attach(0, SEN66_I2C_ADDR_6B, &device);
+
+    // Capture the measurement cycles only; the replays start from the
+    // already configured sensor.
+    const sen66_config_t config = sen66_default_config();
+    CHECK(sen66_bring_up(&config));
+    sensirion_i2c_trace_clear();
+    Sen66PhaseLock lock;
+    int64_t due = sen66_sim::nowUs();
+    int captured = 0;
+    for (int i = 0; i < kCycles; i++) {
+        sen66_data_t data{};
+        captured += test::measureAt(due, lock, &data);
+    }
+    CHECK(captured == kCycles);
+
+    std::vector<uint8_t> bytes;
+    sensirion_i2c_trace_export(appendTo, &bytes);
+    sen66_sim::Trace clean;
+    CHECK(sen66_sim::parseTrace(bytes.data(), bytes.size(), clean));
+    CHECK(clean.dropped == 0);
+    sen66_sim::Trace spiked = clean;
+    const int events = injectSpikes(spiked);
+    CHECK(events == kCycles / kEventSpacing - 1);
+
+    const Replayed base = replay(clean);
+    const Replayed withSpikes = replay(spiked);
+    std::printf("%d samples, %d spike events; reports SMA only %d -> %d, Median<5> + SMA %d -> %d\n",
+                withSpikes.samples, events, base.smaOnly, withSpikes.smaOnly, base.withMedian,
+                withSpikes.withMedian);
+    CHECK(base.samples == kCycles);
+    CHECK(withSpikes.samples == kCycles);
+
+    // Without spikes the median stage changes little. With them, the SMA
+    // spreads each spike over four samples and reports its rise and its fall,
+    // while the median keeps it out of the average altogether: every report
+    // the spikes add to the SMA-only chain is suppressed.
+    CHECK(std::abs(base.withMedian - base.smaOnly) <= base.smaOnly / 10);
+    CHECK(withSpikes.smaOnly - base.smaOnly >= 2 * events);
+    CHECK(withSpikes.withMedian == base.withMedian);
+    CHECK(withSpikes.smaOnly - withSpikes.withMedian >= 2 * events);
+
+    return test::result();
+}
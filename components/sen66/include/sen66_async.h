@@ -0,0 +1,119 @@
+/*
+ * Bus leases for the SEN66.
+ *
+ * One arbiter serves every sensor context and owns the bus between commands:
+ * code that uses the blocking sen66_* functions takes the bus with
+ * sen66_async_acquire() or sen66_async_try_acquire() first and hands it back
+ * with sen66_async_release(). The grants themselves are handed out from
+ * whichever context releases the bus or from an esp_timer, so a waiting task
+ * never polls for it.
+ *
+ * Waiting leases are granted in priority order, FIFO within a priority, so
+ * periodic measurement reads overtake queued maintenance. Maintenance
+ * additionally only starts outside the next measurement slot announced with
+ * sen66_async_reserve(); otherwise it waits for the gap after that read. A
+ * lease with a deadline that has not been granted by then is dropped and
+ * fails with SEN66_ASYNC_DEADLINE_ERROR.
+ */
+
+#ifndef SEN66_ASYNC_H
+#define SEN66_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "sensirion_config.h"
+
+#define SEN66_ASYNC_QUEUE_LENGTH 8
+
+#define SEN66_ASYNC_QUEUE_FULL_ERROR 32
+#define SEN66_ASYNC_NOT_INITIALIZED_ERROR 33
+#define SEN66_ASYNC_DEADLINE_ERROR 35
+#define SEN66_ASYNC_BUSY_ERROR 36
+#define SEN66_ASYNC_TIMEOUT_ERROR 37
+
+typedef enum {
+    SEN66_ASYNC_PRIORITY_MEASUREMENT = 0, // periodic reads, the default
+    SEN66_ASYNC_PRIORITY_MAINTENANCE = 1, // slow commands, run in the gaps
+    SEN66_ASYNC_PRIORITY_COUNT,
+} sen66_async_priority_t;
+
+typedef struct {
+    uint32_t started;   // bus grants
+    uint32_t expired;   // dropped at their deadline
+    uint64_t wait_us;   // summed time from request to grant
+    uint32_t max_wait_us;
+} sen66_async_queue_stats_t;
+
+typedef struct {
+    sen66_async_queue_stats_t priority[SEN66_ASYNC_PRIORITY_COUNT];
+    uint32_t deferred;  // times maintenance was held back for a reserved slot
+} sen66_async_stats_t;
+
+/**
+ * sen66_async_init() - Prepare the arbiter. Safe to call more than once.
+ *
+ * @return NO_ERROR on success, an error code otherwise
+ */
+int16_t sen66_async_init(void);
+
+/**
+ * sen66_async_acquire() - Take the bus for blocking sen66_* calls.
+ *
+ * Queues with the given priority and blocks the calling task until the bus
+ * is granted or the wait runs out; the task wakes at its deadline even while
+ * another lease holds the bus. Must not be called from the esp_timer task,
+ * which hands out the grants.
+ *
+ * @param priority    sen66_async_priority_t of the grant
+ * @param deadline_us Give up if not granted by then, 0 = after
+ *                    SEN66_ASYNC_ACQUIRE_TIMEOUT_US
+ *
+ * @return NO_ERROR once the bus is held, SEN66_ASYNC_DEADLINE_ERROR at the
+ *         deadline, SEN66_ASYNC_TIMEOUT_ERROR when the default wait ran out,
+ *         a queueing error otherwise
+ */
+int16_t sen66_async_acquire(uint8_t priority, int64_t deadline_us);
+
+// Longer than any lease: a supervisor recovery holds the bus for about 2.5 s.
+#define SEN66_ASYNC_ACQUIRE_TIMEOUT_US (5 * 1000 * 1000)
+
+/**
+ * sen66_async_try_acquire() - Take the bus if nobody holds it.
+ *
+ * Never waits for the bus. When it is busy and priority is
+ * SEN66_ASYNC_PRIORITY_MEASUREMENT, queued maintenance is held back for
+ * SEN66_ASYNC_HOLD_US so a retry shortly after wins.
+ *
+ * @param requested_us When the caller first wanted the bus, for the wait
+ *                     statistics
+ *
+ * @return NO_ERROR once the bus is held, SEN66_ASYNC_BUSY_ERROR otherwise
+ */
+int16_t sen66_async_try_acquire(uint8_t priority, int64_t requested_us);
+
+#define SEN66_ASYNC_HOLD_US (100 * 1000)
+
+/**
+ * sen66_async_release() - Hand back a bus taken with sen66_async_acquire()
+ * or sen66_async_try_acquire() and grant it to the next waiter.
+ */
+void sen66_async_release(void);
+
+/**
+ * sen66_async_reserve() - Announce the next measurement slot. Maintenance
+ * that would start less than 10 ms before start_us is deferred until the
+ * slot, plus duration_us, has passed. A later call replaces the reservation.
+ */
+void sen66_async_reserve(int64_t start_us, uint32_t duration_us);
+
+/**
+ * sen66_async_get_stats() - Copy the queue-wait and scheduling counters.
+ */
+void sen66_async_get_stats(sen66_async_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // SEN66_ASYNC_H
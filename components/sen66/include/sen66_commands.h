@@ -0,0 +1,114 @@
+#pragma once
+
+// Compile-time description of every SEN66 command. The driver in
+// sen66_i2c.cpp is generated from this table by a templated executor, so a
+// command's wire format and timing are stated exactly once.
+
+#include <cstdint>
+#include "sen66_i2c.h"
+
+namespace sen66 {
+
+struct Command {
+    uint16_t opcode;
+    uint8_t  tx_words;      // argument words sent after the opcode
+    uint8_t  rx_words;      // response words without CRC, 0 for write-only
+    uint32_t min_exec_us;   // first response poll; the sensor NACKs until ready
+    uint32_t exec_time_us;  // datasheet execution time, upper bound for polling
+
+    constexpr uint16_t txBytes() const { return 2 + tx_words * 3; }
+    constexpr uint16_t rxBytes() const { return rx_words * 2; }
+};
+
+// The datasheet only gives maximum execution times. Commands with a response
+// start polling after 1 ms, since the sensor NACKs its address until the
+// response is ready. Write-only commands always wait the full time because
+// there is nothing to poll.
+namespace cmd {
+
+inline constexpr Command start_continuous_measurement        {SEN66_START_CONTINUOUS_MEASUREMENT_CMD_ID,                 0,  0,   50 * 1000,   50 * 1000};
+inline constexpr Command stop_measurement                    {SEN66_STOP_MEASUREMENT_CMD_ID,                             0,  0, 1000 * 1000, 1000 * 1000};
+inline constexpr Command get_data_ready                      {SEN66_GET_DATA_READY_CMD_ID,                               0,  1,    1 * 1000,   20 * 1000};
+inline constexpr Command read_measured_values_as_integers    {SEN66_READ_MEASURED_VALUES_AS_INTEGERS_CMD_ID,             0,  9,    1 * 1000,   20 * 1000};
+inline constexpr Command read_number_concentration_values    {SEN66_READ_NUMBER_CONCENTRATION_VALUES_AS_INTEGERS_CMD_ID, 0,  5,    1 * 1000,   20 * 1000};
+inline constexpr Command read_measured_raw_values            {SEN66_READ_MEASURED_RAW_VALUES_CMD_ID,                     0,  5,    1 * 1000,   20 * 1000};
+inline constexpr Command start_fan_cleaning                  {SEN66_START_FAN_CLEANING_CMD_ID,                           0,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command set_temperature_offset_parameters   {SEN66_SET_TEMPERATURE_OFFSET_PARAMETERS_CMD_ID,            4,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command set_voc_algorithm_tuning_parameters {SEN66_SET_VOC_ALGORITHM_TUNING_PARAMETERS_CMD_ID,          6,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command get_voc_algorithm_tuning_parameters {SEN66_GET_VOC_ALGORITHM_TUNING_PARAMETERS_CMD_ID,          0,  6,    1 * 1000,   20 * 1000};
+inline constexpr Command set_nox_algorithm_tuning_parameters {SEN66_SET_NOX_ALGORITHM_TUNING_PARAMETERS_CMD_ID,          6,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command get_nox_algorithm_tuning_parameters {SEN66_GET_NOX_ALGORITHM_TUNING_PARAMETERS_CMD_ID,          0,  6,    1 * 1000,   20 * 1000};
+inline constexpr Command set_temperature_acceleration        {SEN66_SET_TEMPERATURE_ACCELERATION_PARAMETERS_CMD_ID,      4,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command set_voc_algorithm_state             {SEN66_SET_VOC_ALGORITHM_STATE_CMD_ID,                      4,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command get_voc_algorithm_state             {SEN66_GET_VOC_ALGORITHM_STATE_CMD_ID,                      0,  4,    1 * 1000,   20 * 1000};
+inline constexpr Command perform_forced_co2_recalibration    {SEN66_PERFORM_FORCED_CO2_RECALIBRATION_CMD_ID,             1,  1,  500 * 1000,  500 * 1000};
+inline constexpr Command set_co2_automatic_self_calibration  {SEN66_SET_CO2_SENSOR_AUTOMATIC_SELF_CALIBRATION_CMD_ID,    1,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command get_co2_automatic_self_calibration  {SEN66_GET_CO2_SENSOR_AUTOMATIC_SELF_CALIBRATION_CMD_ID,    0,  1,    1 * 1000,   20 * 1000};
+inline constexpr Command set_ambient_pressure                {SEN66_SET_AMBIENT_PRESSURE_CMD_ID,                         1,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command get_ambient_pressure                {SEN66_GET_AMBIENT_PRESSURE_CMD_ID,                         0,  1,    1 * 1000,   20 * 1000};
+inline constexpr Command set_sensor_altitude                 {SEN66_SET_SENSOR_ALTITUDE_CMD_ID,                          1,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command get_sensor_altitude                 {SEN66_GET_SENSOR_ALTITUDE_CMD_ID,                          0,  1,    1 * 1000,   20 * 1000};
+inline constexpr Command activate_sht_heater                 {SEN66_ACTIVATE_SHT_HEATER_CMD_ID,                          0,  0,   20 * 1000,   20 * 1000};
+inline constexpr Command get_sht_heater_measurements         {SEN66_GET_SHT_HEATER_MEASUREMENTS_CMD_ID,                  0,  2,    1 * 1000,   20 * 1000};
+inline constexpr Command get_product_name                    {SEN66_GET_PRODUCT_NAME_CMD_ID,                             0, 16,    1 * 1000,   20 * 1000};
+inline constexpr Command get_serial_number                   {SEN66_GET_SERIAL_NUMBER_CMD_ID,                            0, 16,    1 * 1000,   20 * 1000};
+inline constexpr Command get_version                         {SEN66_GET_VERSION_CMD_ID,                                  0,  1,    1 * 1000,   20 * 1000};
+inline constexpr Command read_device_status                  {SEN66_READ_DEVICE_STATUS_CMD_ID,                           0,  2,    1 * 1000,   20 * 1000};
+inline constexpr Command read_and_clear_device_status        {SEN66_READ_AND_CLEAR_DEVICE_STATUS_CMD_ID,                 0,  2,    1 * 1000,   20 * 1000};
+inline constexpr Command device_reset                        {SEN66_DEVICE_RESET_CMD_ID,                                 0,  0, 1200 * 1000, 1200 * 1000};
+
+} // namespace cmd
+
+// Every descriptor, for code that handles commands generically at run time
+// (queueing, reordering, tracing).
+inline constexpr const Command *kCommands[] = {
+    &cmd::start_continuous_measurement,
+    &cmd::stop_measurement,
+    &cmd::get_data_ready,
+    &cmd::read_measured_values_as_integers,
+    &cmd::read_number_concentration_values,
+    &cmd::read_measured_raw_values,
+    &cmd::start_fan_cleaning,
+    &cmd::set_temperature_offset_parameters,
+    &cmd::set_voc_algorithm_tuning_parameters,
+    &cmd::get_voc_algorithm_tuning_parameters,
+    &cmd::set_nox_algorithm_tuning_parameters,
+    &cmd::get_nox_algorithm_tuning_parameters,
+    &cmd::set_temperature_acceleration,
+    &cmd::set_voc_algorithm_state,
+    &cmd::get_voc_algorithm_state,
+    &cmd::perform_forced_co2_recalibration,
+    &cmd::set_co2_automatic_self_calibration,
+    &cmd::get_co2_automatic_self_calibration,
+    &cmd::set_ambient_pressure,
+    &cmd::get_ambient_pressure,
+    &cmd::set_sensor_altitude,
+    &cmd::get_sensor_altitude,
+    &cmd::activate_sht_heater,
+    &cmd::get_sht_heater_measurements,
+    &cmd::get_product_name,
+    &cmd::get_serial_number,
+    &cmd::get_version,
+    &cmd::read_device_status,
+    &cmd::read_and_clear_device_status,
+    &cmd::device_reset,
+};
+
+// Every frame, sent or received with CRCs, has to fit the context buffer.
+constexpr bool fitsBuffer()
+{
+    for (const Command *c : kCommands) {
+        if (c->txBytes() > SEN66_COMMUNICATION_BUFFER_SIZE ||
+            c->rx_words * 3 > SEN66_COMMUNICATION_BUFFER_SIZE)
+            return false;
+    }
+    return true;
+}
+static_assert(fitsBuffer(), "SEN66 command frame exceeds SEN66_COMMUNICATION_BUFFER_SIZE");
+
+// Execute a command without arguments and return its response as raw words,
+// for reads whose descriptor is picked at compile time elsewhere
+// (sen6x_traits.h). words must hold command.rx_words entries.
+int16_t read_words(sen66_ctx_t *ctx, const Command &command, uint16_t *words);
+
+} // namespace sen66
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdbool.h>
+#include <cstdint>
+#include "sen66_i2c.h"
+
+// Sensor settings applied at bring-up, all volatile on the SEN66 (reverted by
+// a power cycle or device reset).
+//
+// sen66_apply_config() avoids the bus traffic of writing them on every boot.
+// A hash of the last configuration applied to each sensor is kept in NVS.
+// The readable settings the module has (altitude and ASC on the CO2 modules,
+// VOC/NOx tuning on those with the gas channels) are read back and only
+// rewritten when they differ; the write-only temperature offset is rewritten
+// unless the read-back proves the sensor kept the configuration recorded in
+// NVS. A sensor that is still measuring after a warm reset rejects the
+// idle-only getters: with a matching hash it is left measuring untouched,
+// otherwise it is stopped and reconfigured. The SEN62 has no readable
+// setting, so it is always stopped and given its temperature offset.
+
+struct sen66_algorithm_tuning_t {
+    int16_t index_offset;
+    int16_t learning_time_offset_hours;
+    int16_t learning_time_gain_hours;
+    int16_t gating_max_duration_minutes;
+    int16_t std_initial;
+    int16_t gain_factor;
+};
+
+struct sen66_config_t {
+    uint16_t altitude_m;
+    // sen66_set_temperature_offset_parameters(), applied to one slot
+    int16_t  temperature_offset;         // [°C] * 200
+    int16_t  temperature_slope;          // * 10000
+    uint16_t temperature_time_constant;  // [s]
+    uint16_t temperature_slot;           // 0..4
+    sen66_algorithm_tuning_t voc_tuning;
+    sen66_algorithm_tuning_t nox_tuning;
+    bool     co2_asc_enabled;
+};
+
+// The sensor's power-on settings.
+sen66_config_t sen66_default_config();
+
+// Bring the sensor at ctx to config, writing only what differs. *measuring is
+// set when the sensor was found measuring with config already in place, in
+// which case it must not be started again. Returns NO_ERROR or the error of
+// the first failing command.
+int16_t sen66_apply_config(sen66_ctx_t *ctx, const sen66_config_t *config, bool *measuring);
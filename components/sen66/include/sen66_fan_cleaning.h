@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include "sen66_i2c.h"
+
+// Runs the SEN66 fan cleaning every periodDays, inside a daily off-peak
+// window of wall-clock hours [windowStartHour, windowStartHour + windowHours),
+// local time as set up by SNTP. Nothing is scheduled until the clock has been
+// set. The time of the last cleaning is kept in NVS, so the period holds
+// across restarts; a sensor without a record is cleaned in the next window.
+//
+// Cleaning needs the sensor idle: the measurement is stopped, the fan runs at
+// full speed for kCleaningUs, then the measurement is started again. PM
+// readings are meaningless from the stop until kSettleUs after the restart,
+// which pmBlanked() reports so the caller can hold its PM outputs.
+class Sen66FanCleaning
+{
+public:
+    static constexpr int64_t kCleaningUs = 10LL * 1000 * 1000; // fan at full speed, sensor idle
+    static constexpr int64_t kSettleUs = 15LL * 1000 * 1000;   // PM after the measurement restarts
+
+    // periodDays == 0 disables the schedule.
+    Sen66FanCleaning(sen66_ctx_t *ctx, uint32_t periodDays, uint8_t windowStartHour, uint8_t windowHours);
+
+    // Call once per acquisition cycle with the bus held, before acquiring.
+    // Starts or finishes a cleaning when due. Returns false while the sensor
+    // is not measuring; skip the acquisition then. Starting blocks for about
+    // a second (stop_measurement).
+    bool onCycle();
+
+    // PM samples taken at nowUs must be discarded.
+    bool pmBlanked(int64_t nowUs) const;
+
+    uint32_t cleanings() const { return mCleanings; }
+
+private:
+    enum class Stage : uint8_t { Idle, Cleaning, Settling };
+
+    bool due();
+    void start(int64_t nowUs, uint32_t epoch);
+    void finish(int64_t nowUs);
+
+    sen66_ctx_t *mCtx;
+    uint32_t mPeriodS;
+    uint8_t mWindowStartHour;
+    uint8_t mWindowHours;
+    Stage mStage = Stage::Idle;
+    bool mLoaded = false;
+    bool mClockLogged = false;
+    uint32_t mLastEpoch = 0;     // wall-clock time of the last cleaning, 0 = unknown
+    uint32_t mRetryEpoch = 0;    // no new attempt before this after a failure
+    int64_t mCleanEndUs = 0;
+    int64_t mBlankEndUs = 0;
+    uint32_t mCleanings = 0;
+};
@@ -44,7 +44,9 @@ extern "C" {
 #endif
 
 #include "sensirion_config.h"
+#include "sensirion_i2c_hal.h"
 #define SEN66_I2C_ADDR_6B 0x6b
+#define SEN66_COMMUNICATION_BUFFER_SIZE 48
 
 typedef enum {
     SEN66_START_CONTINUOUS_MEASUREMENT_CMD_ID = 0x21,
@@ -98,12 +100,26 @@ typedef union {
 } sen66_device_status;
 
 /**
- * @brief Initialize i2c address of driver
+ * Driver state for one sensor. Each context owns its transfer buffer and bus
+ * device, so different sensors can be used from different tasks at the same
+ * time. A single context must not be used by two tasks concurrently.
+ */
+typedef struct {
+    sensirion_i2c_hal_device_t* device;
+    uint8_t bus_idx;
+    uint8_t i2c_address;
+    uint8_t communication_buffer[SEN66_COMMUNICATION_BUFFER_SIZE];
+} sen66_ctx_t;
+
+/**
+ * @brief Initialize a driver context for the sensor at the given address
  *
+ * @param[out] ctx Driver context to set up
+ * @param[in] bus_idx HAL bus the sensor is connected to
  * @param[in] i2c_address Used i2c address
  *
  */
-void sen66_init(uint8_t i2c_address);
+void sen66_init(sen66_ctx_t* ctx, uint8_t bus_idx, uint8_t i2c_address);
 
 /**
  * @brief sen66_signal_co2
@@ -123,9 +139,11 @@ uint16_t sen66_signal_co2(uint16_t co2_raw);
  * ready to read. This command is only available in idle mode. If the device is
  * already in any measure mode, this command has no effect.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
+ *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_start_continuous_measurement();
+int16_t sen66_start_continuous_measurement(sen66_ctx_t* ctx);
 
 /**
  * @brief Stop the continuous measurement
@@ -134,9 +152,11 @@ int16_t sen66_start_continuous_measurement();
  * wait at least 1000 ms before starting a new measurement. If the device is
  * already in idle mode, this command has no effect.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
+ *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_stop_measurement();
+int16_t sen66_stop_measurement(sen66_ctx_t* ctx);
 
 /**
  * @brief Check if data is ready to be read out from the sensor
@@ -145,13 +165,15 @@ int16_t sen66_stop_measurement();
  * read. The data ready flag is automatically reset after reading the
  * measurement values.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] padding Padding byte, always 0x00.
  * @param[out] data_ready True (0x01) if data is ready, False (0x00) if not.
  * When no measurement is running, False will be returned.
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_get_data_ready(uint8_t* padding, bool* data_ready);
+int16_t sen66_get_data_ready(sen66_ctx_t* ctx, uint8_t* padding,
+                             bool* data_ready);
 
 /**
  * @brief read measured values as integers.
@@ -162,6 +184,7 @@ int16_t sen66_get_data_ready(uint8_t* padding, bool* data_ready);
  * available at all (e.g. measurement not running for at least one second), all
  * values will be at their upper limit (0xFFFF for uint16, 0x7FFF for int16).
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] mass_concentration_pm1p0 Value is scaled with factor 10: PM1.0
  * [µg/m³] = value / 10 *Note: If this value is unknown, 0xFFFF is returned.*
  * @param[out] mass_concentration_pm2p5 Value is scaled with factor 10: PM2.5
@@ -186,10 +209,11 @@ int16_t sen66_get_data_ready(uint8_t* padding, bool* data_ready);
  * @return error_code 0 on success, an error code otherwise.
  */
 int16_t sen66_read_measured_values_as_integers(
-    uint16_t* mass_concentration_pm1p0, uint16_t* mass_concentration_pm2p5,
-    uint16_t* mass_concentration_pm4p0, uint16_t* mass_concentration_pm10p0,
-    int16_t* ambient_humidity, int16_t* ambient_temperature, int16_t* voc_index,
-    int16_t* nox_index, uint16_t* co2);
+    sen66_ctx_t* ctx, uint16_t* mass_concentration_pm1p0,
+    uint16_t* mass_concentration_pm2p5, uint16_t* mass_concentration_pm4p0,
+    uint16_t* mass_concentration_pm10p0, int16_t* ambient_humidity,
+    int16_t* ambient_temperature, int16_t* voc_index, int16_t* nox_index,
+    uint16_t* co2);
 
 /**
  * @brief sen66_read_number_concentration_values_as_integers
@@ -201,6 +225,7 @@ int16_t sen66_read_measured_values_as_integers(
  * least one second), all values will be at their upper limit (0xFFFF for
  * uint16).
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] number_concentration_pm0p5 Value is scaled with factor 10: PM0.5
  * [particles/cm³] = value / 10 *Note: If this value is unknown, 0xFFFF is
  * returned.*
@@ -220,8 +245,9 @@ int16_t sen66_read_measured_values_as_integers(
  * @return error_code 0 on success, an error code otherwise.
  */
 int16_t sen66_read_number_concentration_values_as_integers(
-    uint16_t* number_concentration_pm0p5, uint16_t* number_concentration_pm1p0,
-    uint16_t* number_concentration_pm2p5, uint16_t* number_concentration_pm4p0,
+    sen66_ctx_t* ctx, uint16_t* number_concentration_pm0p5,
+    uint16_t* number_concentration_pm1p0, uint16_t* number_concentration_pm2p5,
+    uint16_t* number_concentration_pm4p0,
     uint16_t* number_concentration_pm10p0);
 
 /**
@@ -233,6 +259,7 @@ int16_t sen66_read_number_concentration_values_as_integers(
  * available at all (e.g. measurement not running for at least one second), all
  * values will be at their upper limit (0xFFFF for uint16, 0x7FFF for int16).
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] raw_humidity Value is scaled with factor 100: RH [%] = value /
  * 100 *Note: If this value is unknown, 0x7FFF is returned.*
  * @param[out] raw_temperature Value is scaled with factor 200: T [°C] = value /
@@ -249,7 +276,7 @@ int16_t sen66_read_number_concentration_values_as_integers(
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_read_measured_raw_values(int16_t* raw_humidity,
+int16_t sen66_read_measured_raw_values(sen66_ctx_t* ctx, int16_t* raw_humidity,
                                        int16_t* raw_temperature,
                                        uint16_t* raw_voc, uint16_t* raw_nox,
                                        uint16_t* raw_co2);
@@ -263,9 +290,11 @@ int16_t sen66_read_measured_raw_values(int16_t* raw_humidity,
  *
  * @note This command is only available in idle mode.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
+ *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_start_fan_cleaning();
+int16_t sen66_start_fan_cleaning(sen66_ctx_t* ctx);
 
 /**
  * @brief sen66_set_temperature_offset_parameters
@@ -283,6 +312,7 @@ int16_t sen66_start_fan_cleaning();
  * changed in any state of the device, i.e. both in idle mode and in measure
  * mode.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[in] offset Constant temperature offset scaled with factor 200 (T [°C]
  * = value / 200).
  * @param[in] slope Normalized temperature offset slope scaled with factor 10000
@@ -315,7 +345,8 @@ int16_t sen66_start_fan_cleaning();
  * @endcode
  *
  */
-int16_t sen66_set_temperature_offset_parameters(int16_t offset, int16_t slope,
+int16_t sen66_set_temperature_offset_parameters(sen66_ctx_t* ctx,
+                                                int16_t offset, int16_t slope,
                                                 uint16_t time_constant,
                                                 uint16_t slot);
 
@@ -326,6 +357,7 @@ int16_t sen66_set_temperature_offset_parameters(int16_t offset, int16_t slope,
  * volatile, i.e. the parameters will be reverted to their default values after
  * a device reset.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[in] index_offset VOC index representing typical (average) conditions.
  * Allowed values are in range 1..250. The default value is 100.
  * @param[in] learning_time_offset_hours Time constant to estimate the VOC
@@ -367,7 +399,7 @@ int16_t sen66_set_temperature_offset_parameters(int16_t offset, int16_t slope,
  *
  */
 int16_t sen66_set_voc_algorithm_tuning_parameters(
-    int16_t index_offset, int16_t learning_time_offset_hours,
+    sen66_ctx_t* ctx, int16_t index_offset, int16_t learning_time_offset_hours,
     int16_t learning_time_gain_hours, int16_t gating_max_duration_minutes,
     int16_t std_initial, int16_t gain_factor);
 
@@ -376,6 +408,7 @@ int16_t sen66_set_voc_algorithm_tuning_parameters(
  *
  * Gets the parameters to customize the VOC algorithm.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] index_offset VOC index representing typical (average) conditions.
  * @param[out] learning_time_offset_hours Time constant to estimate the VOC
  * algorithm offset from the history in hours. Past events will be forgotten
@@ -396,9 +429,10 @@ int16_t sen66_set_voc_algorithm_tuning_parameters(
  * @return error_code 0 on success, an error code otherwise.
  */
 int16_t sen66_get_voc_algorithm_tuning_parameters(
-    int16_t* index_offset, int16_t* learning_time_offset_hours,
-    int16_t* learning_time_gain_hours, int16_t* gating_max_duration_minutes,
-    int16_t* std_initial, int16_t* gain_factor);
+    sen66_ctx_t* ctx, int16_t* index_offset,
+    int16_t* learning_time_offset_hours, int16_t* learning_time_gain_hours,
+    int16_t* gating_max_duration_minutes, int16_t* std_initial,
+    int16_t* gain_factor);
 
 /**
  * @brief sen66_set_nox_algorithm_tuning_parameters
@@ -407,6 +441,7 @@ int16_t sen66_get_voc_algorithm_tuning_parameters(
  * volatile, i.e. the parameters will be reverted to their default values after
  * a device reset.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[in] index_offset NOx index representing typical (average) conditions.
  * Allowed values are in range 1..250. The default value is 1.
  * @param[in] learning_time_offset_hours Time constant to estimate the NOx
@@ -448,7 +483,7 @@ int16_t sen66_get_voc_algorithm_tuning_parameters(
  *
  */
 int16_t sen66_set_nox_algorithm_tuning_parameters(
-    int16_t index_offset, int16_t learning_time_offset_hours,
+    sen66_ctx_t* ctx, int16_t index_offset, int16_t learning_time_offset_hours,
     int16_t learning_time_gain_hours, int16_t gating_max_duration_minutes,
     int16_t std_initial, int16_t gain_factor);
 
@@ -457,6 +492,7 @@ int16_t sen66_set_nox_algorithm_tuning_parameters(
  *
  * Gets the parameters to customize the NOx algorithm.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] index_offset NOx index representing typical (average) conditions.
  * @param[out] learning_time_offset_hours Time constant to estimate the NOx
  * algorithm offset from the history in hours. Past events will be forgotten
@@ -478,9 +514,10 @@ int16_t sen66_set_nox_algorithm_tuning_parameters(
  * @return error_code 0 on success, an error code otherwise.
  */
 int16_t sen66_get_nox_algorithm_tuning_parameters(
-    int16_t* index_offset, int16_t* learning_time_offset_hours,
-    int16_t* learning_time_gain_hours, int16_t* gating_max_duration_minutes,
-    int16_t* std_initial, int16_t* gain_factor);
+    sen66_ctx_t* ctx, int16_t* index_offset,
+    int16_t* learning_time_offset_hours, int16_t* learning_time_gain_hours,
+    int16_t* gating_max_duration_minutes, int16_t* std_initial,
+    int16_t* gain_factor);
 
 /**
  * @brief sen66_set_temperature_acceleration_parameters
@@ -490,6 +527,7 @@ int16_t sen66_get_nox_algorithm_tuning_parameters(
  * the RH/T engine with custom values. This configuration is volatile, i.e. the
  * parameters will be reverted to their default values after a device reset.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[in] k Filter constant K scaled with factor 10 (K = value / 10).
  * @param[in] p Filter constant P scaled with factor 10 (P = value / 10).
  * @param[in] t1 Time constant T1 scaled with factor 10 (T1 [s] = value / 10).
@@ -513,7 +551,8 @@ int16_t sen66_get_nox_algorithm_tuning_parameters(
  * @endcode
  *
  */
-int16_t sen66_set_temperature_acceleration_parameters(uint16_t k, uint16_t p,
+int16_t sen66_set_temperature_acceleration_parameters(sen66_ctx_t* ctx,
+                                                      uint16_t k, uint16_t p,
                                                       uint16_t t1, uint16_t t2);
 
 /**
@@ -526,6 +565,7 @@ int16_t sen66_set_temperature_acceleration_parameters(uint16_t k, uint16_t p,
  * retained if a measurement is stopped and started again. If the VOC algorithm
  * state shall be reset, a device reset, or a power cycle can be executed.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[in] state VOC algorithm state to restore.
  *
  * @note This command is only available in idle mode and the state will be
@@ -534,7 +574,7 @@ int16_t sen66_set_temperature_acceleration_parameters(uint16_t k, uint16_t p,
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_set_voc_algorithm_state(const uint8_t* state,
+int16_t sen66_set_voc_algorithm_state(sen66_ctx_t* ctx, const uint8_t* state,
                                       uint16_t state_size);
 
 /**
@@ -547,6 +587,7 @@ int16_t sen66_set_voc_algorithm_state(const uint8_t* state,
  * If the VOC algorithm state shall be reset, a device reset or a power cycle
  * can be executed.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] state Current VOC algorithm state.
  *
  * @note This command can be used either in measure mode or in idle mode (which
@@ -556,7 +597,8 @@ int16_t sen66_set_voc_algorithm_state(const uint8_t* state,
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_get_voc_algorithm_state(uint8_t* state, uint16_t state_size);
+int16_t sen66_get_voc_algorithm_state(sen66_ctx_t* ctx, uint8_t* state,
+                                      uint16_t state_size);
 
 /**
  * @brief Perform Forced CO₂ Recalibration
@@ -564,6 +606,7 @@ int16_t sen66_get_voc_algorithm_state(uint8_t* state, uint16_t state_size);
  * Execute the forced recalibration (FRC) of the CO₂. See the datasheet of the
  * SCD4x sensor for details how the forced recalibration shall be used.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[in] target_co2_concentration Target CO₂ concentration [ppm] of the
  * test setup.
  * @param[out] correction Correction value as received from the SCD [ppm CO₂].
@@ -577,9 +620,8 @@ int16_t sen66_get_voc_algorithm_state(uint8_t* state, uint16_t state_size);
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t
-sen66_perform_forced_co2_recalibration(uint16_t target_co2_concentration,
-                                       uint16_t* correction);
+int16_t sen66_perform_forced_co2_recalibration(
+    sen66_ctx_t* ctx, uint16_t target_co2_concentration, uint16_t* correction);
 
 /**
  * @brief sen66_set_co2_sensor_automatic_self_calibration
@@ -590,6 +632,7 @@ sen66_perform_forced_co2_recalibration(uint16_t target_co2_concentration,
  * enabled. This configuration is volatile, i.e. the parameter will be reverted
  * to its default value after a device restart.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[in] status Set to true (0x0001) to enable or false (0x0000) to disable
  * the automatic CO₂ measurement self calibration feature. High byte of uint16
  * is padding and always 0x00.
@@ -612,7 +655,8 @@ sen66_perform_forced_co2_recalibration(uint16_t target_co2_concentration,
  * @endcode
  *
  */
-int16_t sen66_set_co2_sensor_automatic_self_calibration(uint16_t status);
+int16_t sen66_set_co2_sensor_automatic_self_calibration(sen66_ctx_t* ctx,
+                                                        uint16_t status);
 
 /**
  * @brief sen66_get_co2_sensor_automatic_self_calibration
@@ -622,6 +666,7 @@ int16_t sen66_set_co2_sensor_automatic_self_calibration(uint16_t status);
  * default it is enabled. This configuration is volatile, i.e. the parameter
  * will be reverted to its default value after a device restart.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] padding Padding byte, always 0x00.
  * @param[out] status Is set true (0x01) if the automatic self calibration is
  * enabled or false (0x00) if the automatic self calibration is disabled.
@@ -630,7 +675,8 @@ int16_t sen66_set_co2_sensor_automatic_self_calibration(uint16_t status);
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_get_co2_sensor_automatic_self_calibration(uint8_t* padding,
+int16_t sen66_get_co2_sensor_automatic_self_calibration(sen66_ctx_t* ctx,
+                                                        uint8_t* padding,
                                                         bool* status);
 
 /**
@@ -644,6 +690,7 @@ int16_t sen66_get_co2_sensor_automatic_self_calibration(uint8_t* padding,
  * value is 1013 hPa. This configuration is volatile, i.e. the parameter will be
  * reverted to its default value after a device restart.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[in] ambient_pressure Ambient pressure [hPa] to be used for pressure
  * compensation.
  *
@@ -666,7 +713,7 @@ int16_t sen66_get_co2_sensor_automatic_self_calibration(uint8_t* padding,
  * @endcode
  *
  */
-int16_t sen66_set_ambient_pressure(uint16_t ambient_pressure);
+int16_t sen66_set_ambient_pressure(sen66_ctx_t* ctx, uint16_t ambient_pressure);
 
 /**
  * @brief sen66_get_ambient_pressure
@@ -674,6 +721,7 @@ int16_t sen66_set_ambient_pressure(uint16_t ambient_pressure);
  * Gets the ambient pressure value. The ambient pressure can be used for
  * pressure compensation in the CO₂ sensor.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] ambient_pressure Currently used ambient pressure [hPa] for
  * pressure compensation.
  *
@@ -682,7 +730,8 @@ int16_t sen66_set_ambient_pressure(uint16_t ambient_pressure);
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_get_ambient_pressure(uint16_t* ambient_pressure);
+int16_t sen66_get_ambient_pressure(sen66_ctx_t* ctx,
+                                   uint16_t* ambient_pressure);
 
 /**
  * @brief sen66_set_sensor_altitude
@@ -692,6 +741,7 @@ int16_t sen66_get_ambient_pressure(uint16_t* ambient_pressure);
  * input values are between 0 and 3000m. This configuration is volatile, i.e.
  * the parameter will be reverted to its default value after a device reset.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[in] altitude Sensor altitude [m], valid input between 0 and 3000m.
  *
  * @return error_code 0 on success, an error code otherwise.
@@ -710,7 +760,7 @@ int16_t sen66_get_ambient_pressure(uint16_t* ambient_pressure);
  * @endcode
  *
  */
-int16_t sen66_set_sensor_altitude(uint16_t altitude);
+int16_t sen66_set_sensor_altitude(sen66_ctx_t* ctx, uint16_t altitude);
 
 /**
  * @brief sen66_get_sensor_altitude
@@ -718,13 +768,14 @@ int16_t sen66_set_sensor_altitude(uint16_t altitude);
  * Gets the current sensor altitude. The sensor altitude can be used for
  * pressure compensation in the CO₂ sensor.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] altitude Current sensor altitude [m].
  *
  * @note This command is only available in idle mode.
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_get_sensor_altitude(uint16_t* altitude);
+int16_t sen66_get_sensor_altitude(sen66_ctx_t* ctx, uint16_t* altitude);
 
 /**
  * @brief Activate SHT Heater
@@ -741,9 +792,11 @@ int16_t sen66_get_sensor_altitude(uint16_t* altitude);
  * 4.0, wait for at least 1300ms before sending another command, to ensure
  * heating is finsihed.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
+ *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_activate_sht_heater();
+int16_t sen66_activate_sht_heater(sen66_ctx_t* ctx);
 
 /**
  * @brief Get the measurement values when the SHT sensor heating is finished.
@@ -752,6 +805,7 @@ int16_t sen66_activate_sht_heater();
  * heating is not finished, the returned humidity and temperature values are
  * 0x7FFF.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] humidity Value is scaled with factor 100: RH [%] = value / 100
  * *Note: If this value is not available, 0x7FFF is returned.*
  * @param[out] temperature Value is scaled with factor 200: T [°C] = value / 200
@@ -764,7 +818,7 @@ int16_t sen66_activate_sht_heater();
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_get_sht_heater_measurements(int16_t* humidity,
+int16_t sen66_get_sht_heater_measurements(sen66_ctx_t* ctx, int16_t* humidity,
                                           int16_t* temperature);
 
 /**
@@ -772,12 +826,13 @@ int16_t sen66_get_sht_heater_measurements(int16_t* humidity,
  *
  * Gets the product name from the device.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] product_name Null-terminated ASCII string containing the product
  * name. Up to 32 characters can be read from the device.
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_get_product_name(int8_t* product_name,
+int16_t sen66_get_product_name(sen66_ctx_t* ctx, int8_t* product_name,
                                uint16_t product_name_size);
 
 /**
@@ -785,12 +840,13 @@ int16_t sen66_get_product_name(int8_t* product_name,
  *
  * Gets the serial number from the device.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] serial_number Null-terminated ASCII string containing the serial
  * number. Up to 32 characters can be read from the device.
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_get_serial_number(int8_t* serial_number,
+int16_t sen66_get_serial_number(sen66_ctx_t* ctx, int8_t* serial_number,
                                 uint16_t serial_number_size);
 
 /**
@@ -799,12 +855,14 @@ int16_t sen66_get_serial_number(int8_t* serial_number,
  * Gets the version information for the hardware, firmware and communication
  * protocol.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] firmware_major Firmware major version number.
  * @param[out] firmware_minor Firmware minor version number.
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_get_version(uint8_t* firmware_major, uint8_t* firmware_minor);
+int16_t sen66_get_version(sen66_ctx_t* ctx, uint8_t* firmware_major,
+                          uint8_t* firmware_minor);
 
 /**
  * @brief sen66_read_device_status
@@ -816,6 +874,7 @@ int16_t sen66_get_version(uint8_t* firmware_major, uint8_t* firmware_minor);
  * corresponding flag values. For details about the available flags, refer to
  * the device status flags documentation in the data sheet.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] device_status Device status (32 flags as an integer value). For
  * details, please refer to the device status flags documentation in the
  * datasheet.
@@ -828,7 +887,8 @@ int16_t sen66_get_version(uint8_t* firmware_major, uint8_t* firmware_minor);
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_read_device_status(sen66_device_status* device_status);
+int16_t sen66_read_device_status(sen66_ctx_t* ctx,
+                                 sen66_device_status* device_status);
 
 /**
  * @brief sen66_read_and_clear_device_status
@@ -836,22 +896,26 @@ int16_t sen66_read_device_status(sen66_device_status* device_status);
  * Reads the current device status (like command 0xD206 "Read Device Status")
  * and afterwards clears all flags.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
  * @param[out] device_status Device status (32 flags as an integer value)
  * **before** clearing it. For details, please refer to the device status flags
  * documentation.
  *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_read_and_clear_device_status(sen66_device_status* device_status);
+int16_t sen66_read_and_clear_device_status(sen66_ctx_t* ctx,
+                                           sen66_device_status* device_status);
 
 /**
  * @brief sen66_device_reset
  *
  * Executes a reset on the device. This has the same effect as a power cycle.
  *
+ * @param[in,out] ctx Driver context set up with sen66_init()
+ *
  * @return error_code 0 on success, an error code otherwise.
  */
-int16_t sen66_device_reset();
+int16_t sen66_device_reset(sen66_ctx_t* ctx);
 
 #ifdef __cplusplus
 }
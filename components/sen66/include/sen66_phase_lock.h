@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+// Tracks the phase of the SEN66's internal 1 Hz measurement update so reads
+// can be scheduled just after new data appears instead of polling for it.
+//
+// The data-ready flag is only cleared by reading the values, so an update is
+// observed as: a read clears the flag, a later check finds it set again. When
+// that bracket is narrow enough it measures the update edge and locks the
+// phase; edges at least ten periods apart also refine the period.
+//
+// While locked, each cycle clears the flag kLeadUs before the predicted update
+// and checks it kGuardUs after. Finding no data there is a miss: the lock is
+// dropped and the caller polls until the edge has been measured again.
+class Sen66PhaseLock
+{
+public:
+    static constexpr int64_t kNominalPeriodUs = 1000 * 1000;
+    static constexpr int64_t kLeadUs = 30 * 1000;          // clearing read before the predicted update
+    static constexpr int64_t kGuardUs = 10 * 1000;         // data-ready check after it
+    static constexpr int64_t kMaxEdgeWindowUs = 15 * 1000; // widest bracket taken as an edge measurement
+
+    // Time of the clearing read for the first predicted update that leaves
+    // at least kLeadUs after notBeforeUs. Returns notBeforeUs while unlocked.
+    int64_t nextReadUs(int64_t notBeforeUs) const;
+
+    // First predicted update at or after timeUs. Only meaningful while locked.
+    int64_t nextUpdateUs(int64_t timeUs) const;
+
+    // The data-ready flag was cleared by a read started at timeUs.
+    void onCleared(int64_t timeUs);
+
+    // Report one data-ready check. For ready == true pass a time taken after
+    // the check, otherwise one taken before it, so the edge is bracketed
+    // conservatively.
+    void onDataReady(bool ready, int64_t timeUs);
+
+    bool locked() const { return mLocked; }
+    int64_t periodUs() const { return mPeriodUs; }
+    uint32_t hits() const { return mHits; }      // checks that found the predicted update
+    uint32_t misses() const { return mMisses; }  // checks that found none and dropped the lock
+    uint32_t locks() const { return mLocks; }    // edges measured, initial lock included
+
+private:
+    bool mLocked = false;
+    bool mHaveEdge = false;
+    int64_t mEdgeUs = 0;            // last measured update
+    int64_t mAnchorUs = 0;          // older measured update the period is derived from
+    int64_t mPeriodUs = kNominalPeriodUs;
+    int64_t mLastNotReadyUs = -1;   // latest time the flag was known clear, -1 if none
+    uint32_t mHits = 0;
+    uint32_t mMisses = 0;
+    uint32_t mLocks = 0;
+};
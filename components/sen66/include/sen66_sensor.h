@@ -2,6 +2,9 @@
 
 #include <stdbool.h>
 #include <cstdint>
+#include "sen66_config.h"
+#include "sen66_i2c.h"
+#include "sen66_phase_lock.h"
 
 struct sen66_data_t {
     int16_t  raw_temperature;      // 0..0x7FFE valid, 0x7FFF = invalid
@@ -20,11 +23,94 @@ struct sen66_data_t {
     float    nox_index;
     uint16_t raw_co2;             // 0..0xFFFE valid, 0xFFFF = invalid
     float    co2_equivalent;      // = raw_co2
+    uint16_t raw_hcho;            // 0..0xFFFE valid, 0xFFFF = invalid
+    float    hcho;                // = raw_hcho / 10.0f [ppb]
 };
 
+// Frames of an extended acquisition, selected per cycle. The measured values
+// are always read: doing so is what clears data-ready. Raw values only exist
+// on modules whose traits set kRawValues (sen6x_traits.h); elsewhere the bit
+// is ignored.
+enum : uint8_t {
+    SEN66_FRAME_VALUES = 1 << 0,                // read_measured_values_as_integers
+    SEN66_FRAME_NUMBER_CONCENTRATIONS = 1 << 1, // read_number_concentration_values_as_integers
+    SEN66_FRAME_RAW = 1 << 2,                   // read_measured_raw_values
+    SEN66_FRAME_ALL = 0x07,
+};
+
+// One acquisition as the sensor sent it: integer words with the sensor's
+// scaling and invalid markers (0xFFFF, 0x7FFF), frames read back to back.
+// Packed, so it can be stored or sent as is; fields of frames not read this
+// cycle, and of channels the module (sen6x::Active) lacks, are left invalid.
+struct __attribute__((packed)) sen66_record_t {
+    int64_t  timestamp_us;     // esp_timer time of the data-ready check
+    uint8_t  frames;           // SEN66_FRAME_* read into this record
+    // SEN66_FRAME_VALUES
+    uint16_t pm1_0, pm2_5, pm4_0, pm10_0; // [µg/m³] * 10
+    int16_t  humidity;         // [%RH] * 100
+    int16_t  temperature;      // [°C] * 200
+    int16_t  voc_index;        // * 10
+    int16_t  nox_index;        // * 10
+    uint16_t co2;              // [ppm]
+    uint16_t hcho;             // [ppb] * 10
+    // SEN66_FRAME_NUMBER_CONCENTRATIONS, [particles/cm³] * 10
+    uint16_t nc0_5, nc1_0, nc2_5, nc4_0, nc10_0;
+    // SEN66_FRAME_RAW
+    int16_t  raw_humidity;     // [%RH] * 100
+    int16_t  raw_temperature;  // [°C] * 200
+    uint16_t raw_voc;          // ticks
+    uint16_t raw_nox;          // ticks
+    uint16_t raw_co2;          // [ppm], not interpolated
+};
+
+// Decode the measured-values frame of a record (raw_* and float fields).
+void sen66_record_to_data(const sen66_record_t *record, sen66_data_t *data);
+
+// Mark the mass and number concentrations of a record invalid, e.g. while
+// the fan is being cleaned (sen66_fan_cleaning.h).
+void sen66_record_blank_pm(sen66_record_t *record);
+
+// Returned by sen66_read_data() while the sensor has no new sample yet.
+#define SEN66_DATA_NOT_READY_ERROR 34
+
+// Single-sensor API: initialises the I2C HAL and drives the sensor at
+// SEN66_I2C_ADDR_6B through sen66_default_ctx().
 void sen66_i2c_init(uint16_t sensorAltitudeM);
 bool sen66_get_measurement(sen66_data_t *out_data);
+bool sen66_get_measurement(Sen66PhaseLock &phaseLock, sen66_data_t *out_data);
+bool sen66_get_measurement(Sen66PhaseLock &phaseLock, uint8_t frames, sen66_record_t *out_record);
 void sen66_start_measurement();
-bool sen66_read_data(sen66_data_t *data);
+int16_t sen66_read_data(sen66_data_t *data);
+sen66_ctx_t *sen66_default_ctx();
+// Full start-up of the default sensor: I2C HAL, configuration (cached, see
+// sen66_config.h), VOC state restore and measurement start. Blocks for tens
+// of milliseconds on a cold boot, longer when a running sensor must be
+// reconfigured; meant to run on its own task alongside the rest of init.
+// Returns true once the sensor is measuring.
+bool sen66_bring_up(const sen66_config_t *config);
+
+// Per-sensor API for setups with several SEN66 units, possibly spread over
+// both I2C buses. The I2C HAL must be initialised before sen66_sensor_init()
+// is called.
+void sen66_sensor_init(sen66_ctx_t *ctx, uint8_t busIdx, uint8_t i2cAddress, uint16_t sensorAltitudeM);
+bool sen66_bring_up(sen66_ctx_t *ctx, uint8_t busIdx, uint8_t i2cAddress, const sen66_config_t *config);
+// The part of sen66_bring_up() after sen66_init(): configure, restore the VOC
+// state and start measuring. Also used to bring a sensor back after
+// sen66_device_reset().
+bool sen66_configure_and_start(sen66_ctx_t *ctx, const sen66_config_t *config);
+bool sen66_get_measurement(sen66_ctx_t *ctx, sen66_data_t *out_data);
+// Phase-locked variant, meant to be called at phaseLock.nextReadUs(). While
+// locked it clears data-ready just before the predicted update and reads the
+// new sample right after it (read, check, read); otherwise it polls every
+// 10 ms until the next update, at most about a second, to re-learn the phase.
+bool sen66_get_measurement(sen66_ctx_t *ctx, Sen66PhaseLock &phaseLock, sen66_data_t *out_data);
+// Same, reading the selected frames (SEN66_FRAME_*) into a record; each
+// extra frame costs one short command, about 3 ms of bus time.
+bool sen66_get_measurement(sen66_ctx_t *ctx, Sen66PhaseLock &phaseLock, uint8_t frames, sen66_record_t *out_record);
+void sen66_start_measurement(sen66_ctx_t *ctx);
+// Returns NO_ERROR when data was decoded, SEN66_DATA_NOT_READY_ERROR or the
+// I2C/CRC error of the failing transfer otherwise.
+int16_t sen66_read_data(sen66_ctx_t *ctx, sen66_data_t *data);
+int16_t sen66_read_record(sen66_ctx_t *ctx, uint8_t frames, sen66_record_t *record);
 
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include "sen66_config.h"
+#include "sen66_i2c.h"
+
+// Watches the SEN66 device status and repairs the sensor in place, without
+// restarting the ESP32 or the Matter stack.
+//
+// The status is read every checkEvery acquisition cycles, and right away
+// once kFailedReadLimit acquisitions in a row have failed. A fault is a
+// sticky error flag (fan, RHT, gas, CO2, PM), an unreadable status, or the
+// run of failed acquisitions. Each following cycle checks again and, while
+// the fault persists, escalates one step:
+//
+//   clear the flags -> stop/start the measurement -> device reset (followed
+//   by reconfiguration and VOC state restore)
+//
+// Failed acquisitions skip the clearing step, since a sensor that stopped
+// measuring reports a clean status. A ladder that ends faulty is retried
+// from the restart step after kRetryCycles. Recovery means a clean status
+// and a successful acquisition in the same cycle.
+class Sen66Supervisor
+{
+public:
+    static constexpr uint32_t kFailedReadLimit = 3;
+    static constexpr uint32_t kRetryCycles = 120;
+
+    struct Stats {
+        uint32_t checks = 0;         // status reads
+        uint32_t warnings = 0;       // checks that saw the fan speed warning
+        uint32_t faults = 0;         // fault episodes
+        uint32_t clears = 0;         // recovery steps taken
+        uint32_t restarts = 0;
+        uint32_t resets = 0;
+        uint32_t unrecovered = 0;    // ladders that ended still faulty
+        uint32_t lastStatus = 0;     // raw device status of the last read
+        int64_t lastRecoveryUs = 0;  // fault detection to recovery
+        int64_t maxRecoveryUs = 0;
+    };
+
+    Sen66Supervisor(sen66_ctx_t *ctx, const sen66_config_t &config, uint32_t checkEvery = 12);
+
+    // Call once per acquisition cycle, with the bus held. acquired tells
+    // whether this cycle's acquisition succeeded. Recovery steps block for
+    // up to about 2.5 s (stop_measurement, device_reset).
+    void onCycle(bool acquired);
+
+    bool recovering() const { return mStage != Stage::Healthy; }
+    const Stats &stats() const { return mStats; }
+
+private:
+    enum class Stage : uint8_t { Healthy, Cleared, Restarted, Reset, Failed };
+
+    void escalate(bool statusError);
+    void clear();
+    void restart();
+    void reset();
+    void recovered(int64_t nowUs);
+
+    sen66_ctx_t *mCtx;
+    sen66_config_t mConfig;
+    uint32_t mCheckEvery;
+    uint32_t mCycle = 0;
+    uint32_t mFailedReads = 0;
+    uint32_t mRetryAtCycle = 0;
+    int64_t mFaultStartUs = 0;
+    Stage mStage = Stage::Healthy;
+    Stats mStats;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+#include <cstdint>
+#include "sen66_i2c.h"
+
+// Keeps the SEN66 VOC algorithm state across restarts, so the VOC index is
+// meaningful within seconds of a reboot or OTA instead of after hours of
+// relearning.
+//
+// Snapshots are read with sen66_get_voc_algorithm_state(), which also works
+// while measuring. Every snapshot is kept in RTC memory, which survives
+// software resets, panics and watchdog resets at no flash cost; every
+// CONFIG_SEN66_VOC_STATE_NVS_INTERVAL_MIN minutes it is also written to NVS
+// for power cycles. Restoring prefers the RTC copy and falls back to NVS.
+// Copies are keyed by bus and address and checksummed, so a cold boot's
+// uninitialised RTC memory is never mistaken for a state.
+
+#define SEN66_VOC_STATE_SIZE 8
+
+// Write the saved state, if any, to the sensor at ctx. The command is only
+// accepted in idle mode: call it after sen66_sensor_init() and before the
+// measurement is started. Returns true when a state was restored. After a
+// warm reset the sensor may still be measuring; it then rejects the state
+// but has kept its own.
+bool sen66_voc_state_restore(sen66_ctx_t *ctx);
+
+// Read the current state from the sensor at ctx into RTC memory, and into NVS
+// when the last NVS write is older than the configured interval. Costs one
+// short I2C command; returns the I2C error, if any.
+int16_t sen66_voc_state_snapshot(sen66_ctx_t *ctx);
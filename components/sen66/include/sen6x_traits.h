@@ -0,0 +1,129 @@
+#pragma once
+
+// Compile-time description of the Sensirion SEN6x modules this driver can
+// run. The family shares the SEN66 command set (sen66_commands.h) except for
+// the measured-values read, whose opcode and word layout depend on the
+// channels a module has. Each build targets one module, picked in menuconfig
+// (CONFIG_SEN6X_MODEL_*), and sen6x::Active names its traits. Everything that
+// depends on the channels asks Active::has() in an if constexpr, so code and
+// Matter clusters for channels the module lacks are not compiled in.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "sdkconfig.h"
+#include "sen66_commands.h"
+
+namespace sen6x {
+
+enum Channel : uint16_t {
+    PM1_0       = 1 << 0,
+    PM2_5       = 1 << 1,
+    PM4_0       = 1 << 2,
+    PM10_0      = 1 << 3,
+    HUMIDITY    = 1 << 4,
+    TEMPERATURE = 1 << 5,
+    VOC_INDEX   = 1 << 6,
+    NOX_INDEX   = 1 << 7,
+    CO2         = 1 << 8,
+    HCHO        = 1 << 9,
+};
+
+// Wire format, the same on every module: signed words use 0x7FFF as the
+// invalid marker, unsigned ones 0xFFFF; value = word / scale.
+constexpr bool isSigned(Channel c) {
+    return c == HUMIDITY || c == TEMPERATURE || c == VOC_INDEX || c == NOX_INDEX;
+}
+
+constexpr float scale(Channel c) {
+    switch (c) {
+    case HUMIDITY:    return 100.0f; // %RH
+    case TEMPERATURE: return 200.0f; // °C
+    case CO2:         return 1.0f;   // ppm
+    default:          return 10.0f;  // µg/m³, index points, ppb (HCHO)
+    }
+}
+
+// Physical value of a measured word, NaN for the invalid marker.
+constexpr float decode(Channel c, uint16_t word) {
+    if (isSigned(c))
+        return word == 0x7FFF ? NAN : static_cast<int16_t>(word) / scale(c);
+    return word == 0xFFFF ? NAN : word / scale(c);
+}
+
+// CRTP base: derives the channel queries from the model's kLayout, the word
+// order of its measured-values frame.
+template <class Model>
+struct Traits {
+    static constexpr size_t words() { return sizeof(Model::kLayout) / sizeof(Model::kLayout[0]); }
+
+    static constexpr uint16_t channels() {
+        uint16_t mask = 0;
+        for (Channel c : Model::kLayout)
+            mask |= c;
+        return mask;
+    }
+
+    static constexpr bool has(Channel c) { return (channels() & c) != 0; }
+
+    static constexpr bool valid() {
+        return Model::kReadValues.tx_words == 0 && Model::kReadValues.rx_words == words();
+    }
+};
+
+// Measured-values read of each module; timing as for the SEN66 read.
+constexpr sen66::Command readValues(uint16_t opcode, uint8_t words) {
+    return {opcode, 0, words, 1 * 1000, 20 * 1000};
+}
+
+struct Sen62 : Traits<Sen62> {
+    static constexpr const char *kName = "SEN62";
+    static constexpr sen66::Command kReadValues = readValues(0x04a3, 6);
+    static constexpr Channel kLayout[] = {PM1_0, PM2_5, PM4_0, PM10_0, HUMIDITY, TEMPERATURE};
+    static constexpr bool kRawValues = false;
+};
+
+struct Sen63c : Traits<Sen63c> {
+    static constexpr const char *kName = "SEN63C";
+    static constexpr sen66::Command kReadValues = readValues(0x0471, 7);
+    static constexpr Channel kLayout[] = {PM1_0, PM2_5, PM4_0, PM10_0, HUMIDITY, TEMPERATURE, CO2};
+    static constexpr bool kRawValues = false;
+};
+
+struct Sen65 : Traits<Sen65> {
+    static constexpr const char *kName = "SEN65";
+    static constexpr sen66::Command kReadValues = readValues(0x0446, 8);
+    static constexpr Channel kLayout[] = {PM1_0, PM2_5, PM4_0, PM10_0, HUMIDITY, TEMPERATURE, VOC_INDEX, NOX_INDEX};
+    static constexpr bool kRawValues = false;
+};
+
+struct Sen66 : Traits<Sen66> {
+    static constexpr const char *kName = "SEN66";
+    static constexpr sen66::Command kReadValues = sen66::cmd::read_measured_values_as_integers;
+    static constexpr Channel kLayout[] = {PM1_0, PM2_5, PM4_0, PM10_0, HUMIDITY, TEMPERATURE, VOC_INDEX, NOX_INDEX, CO2};
+    static constexpr bool kRawValues = true; // sen66_read_measured_raw_values() layout
+};
+
+struct Sen68 : Traits<Sen68> {
+    static constexpr const char *kName = "SEN68";
+    static constexpr sen66::Command kReadValues = readValues(0x0467, 9);
+    static constexpr Channel kLayout[] = {PM1_0, PM2_5, PM4_0, PM10_0, HUMIDITY, TEMPERATURE, VOC_INDEX, NOX_INDEX, HCHO};
+    static constexpr bool kRawValues = false;
+};
+
+#if CONFIG_SEN6X_MODEL_SEN62
+using Active = Sen62;
+#elif CONFIG_SEN6X_MODEL_SEN63C
+using Active = Sen63c;
+#elif CONFIG_SEN6X_MODEL_SEN65
+using Active = Sen65;
+#elif CONFIG_SEN6X_MODEL_SEN68
+using Active = Sen68;
+#else
+using Active = Sen66;
+#endif
+
+static_assert(Sen62::valid() && Sen63c::valid() && Sen65::valid() && Sen66::valid() && Sen68::valid(),
+              "measured-values command does not match the channel layout");
+
+} // namespace sen6x
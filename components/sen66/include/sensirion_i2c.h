@@ -33,6 +33,7 @@
 #define SENSIRION_I2C_H
 
 #include "sensirion_config.h"
+#include "sensirion_i2c_hal.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -57,6 +58,24 @@ uint8_t sensirion_i2c_generate_crc(const uint8_t* data, uint16_t count);
 int8_t sensirion_i2c_check_crc(const uint8_t* data, uint16_t count,
                                uint8_t checksum);
 
+/**
+ * sensirion_i2c_check_crc_and_compact() - Validate and strip the CRC bytes of
+ * a received frame in a single pass.
+ *
+ * Every 3-byte group (2 data bytes + CRC) is checked and its data bytes are
+ * moved to the front of the buffer, so on success the first
+ * received_length / 3 * 2 bytes hold the payload.
+ *
+ * @param buffer          Received frame, compacted in place
+ * @param received_length Number of received bytes including CRC. Needs to be
+ *                        a multiple of SENSIRION_WORD_SIZE + CRC8_LEN,
+ *                        otherwise the function returns BYTE_NUM_ERROR.
+ *
+ * @return NO_ERROR on success, CRC_ERROR on the first mismatching word
+ */
+int16_t sensirion_i2c_check_crc_and_compact(uint8_t* buffer,
+                                            uint16_t received_length);
+
 /**
  * sensirion_i2c_general_call_reset() - Send a general call reset.
  *
@@ -341,6 +360,24 @@ int16_t sensirion_i2c_write_data(uint8_t address, const uint8_t* data,
  */
 int16_t sensirion_i2c_read_data_inplace(uint8_t address, uint8_t* buffer,
                                         uint16_t expected_data_length);
+
+/**
+ * sensirion_i2c_device_write_data() - Same as sensirion_i2c_write_data() for a
+ * device handle obtained from sensirion_i2c_hal_get_device().
+ */
+int16_t sensirion_i2c_device_write_data(sensirion_i2c_hal_device_t* device,
+                                        const uint8_t* data,
+                                        uint16_t data_length);
+
+/**
+ * sensirion_i2c_device_read_data_inplace() - Same as
+ * sensirion_i2c_read_data_inplace() for a device handle obtained from
+ * sensirion_i2c_hal_get_device().
+ */
+int16_t
+sensirion_i2c_device_read_data_inplace(sensirion_i2c_hal_device_t* device,
+                                       uint8_t* buffer,
+                                       uint16_t expected_data_length);
 #ifdef __cplusplus
 }
 #endif
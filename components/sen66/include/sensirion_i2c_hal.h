@@ -56,6 +56,27 @@ int16_t sensirion_i2c_hal_select_bus(uint8_t bus_idx);
  */
 void sensirion_i2c_hal_init(void);
 
+/** Number of I2C controllers the HAL can drive (I2C_NUM_0 and I2C_NUM_1). */
+#define SENSIRION_I2C_HAL_MAX_BUSES 2
+
+typedef struct {
+    int sda_io;            // SDA GPIO number
+    int scl_io;            // SCL GPIO number
+    uint32_t frequency_hz; // SCL frequency for devices on this bus
+} sensirion_i2c_hal_bus_config_t;
+
+/**
+ * Bring up one bus with explicit pins. sensirion_i2c_hal_init() does this for
+ * the buses configured in menuconfig; call it directly for other layouts.
+ * Initializing an already running bus is a no-op.
+ *
+ * @param bus_idx Bus / controller index, < SENSIRION_I2C_HAL_MAX_BUSES
+ * @param config  Pins and clock of the bus
+ * @returns 0 on success, an error code otherwise
+ */
+int16_t sensirion_i2c_hal_init_bus(uint8_t bus_idx,
+                                   const sensirion_i2c_hal_bus_config_t* config);
+
 /**
  * Release all resources initialized by sensirion_i2c_hal_init().
  */
@@ -87,6 +108,203 @@ int8_t sensirion_i2c_hal_read(uint8_t address, uint8_t* data, uint8_t count);
 int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t* data,
                                uint8_t count);
 
+/**
+ * Opaque handle of one device (address) on the bus. Obtained once with
+ * sensirion_i2c_hal_get_device() and then used for all transfers, so drivers
+ * for several sensors do not share any hidden per-address state.
+ */
+typedef struct sensirion_i2c_hal_device sensirion_i2c_hal_device_t;
+
+/**
+ * Look up or register the device with the given address on the given bus.
+ * Safe to call from several tasks; repeated calls for the same bus and address
+ * return the same handle.
+ *
+ * @param bus_idx Bus the device is connected to
+ * @param address 7-bit I2C address of the device
+ * @returns the device handle, NULL if the bus is not initialized or no more
+ *          devices can be registered
+ */
+sensirion_i2c_hal_device_t* sensirion_i2c_hal_get_device(uint8_t bus_idx,
+                                                         uint8_t address);
+
+/**
+ * Same as sensirion_i2c_hal_read() for an already resolved device.
+ *
+ * Failed transfers are retried up to CONFIG_SEN66_I2C_MAX_RETRIES times with
+ * exponential backoff; the last error is returned, never treated as fatal.
+ */
+int8_t sensirion_i2c_hal_device_read(sensirion_i2c_hal_device_t* dev,
+                                     uint8_t* data, uint8_t count);
+
+/**
+ * Same as sensirion_i2c_hal_write() for an already resolved device, with the
+ * same retry behaviour as sensirion_i2c_hal_device_read().
+ */
+int8_t sensirion_i2c_hal_device_write(sensirion_i2c_hal_device_t* dev,
+                                      const uint8_t* data, uint8_t count);
+
+/**
+ * Write then read in one transaction (repeated start), for register reads on
+ * other devices sharing the bus, e.g. an EEPROM or a pressure sensor. Same
+ * retry behaviour as sensirion_i2c_hal_device_read().
+ */
+int8_t sensirion_i2c_hal_device_write_read(sensirion_i2c_hal_device_t* dev,
+                                           const uint8_t* tx, uint8_t tx_count,
+                                           uint8_t* rx, uint8_t rx_count);
+
+/**
+ * Single read attempt without retries, for polling a sensor that NACKs its
+ * address while a command is still executing. NACKs are counted as poll_nacks
+ * instead of nack_errors.
+ *
+ * @returns 0 on success, I2C_NACK_ERROR while the device is busy, another
+ *          error code otherwise
+ */
+int8_t sensirion_i2c_hal_device_poll_read(sensirion_i2c_hal_device_t* dev,
+                                          uint8_t* data, uint8_t count);
+
+/**
+ * Recover a device after a bus error: reset the bus (which also clocks SCL to
+ * free a slave holding SDA low) and re-register the device handle. The
+ * transfer functions do this on their own after a bus error or timeout.
+ *
+ * Do not call while a transaction on the same bus is outstanding.
+ *
+ * @param dev device whose transfer failed
+ * @returns 0 on success, error code otherwise
+ */
+int16_t sensirion_i2c_hal_recover(sensirion_i2c_hal_device_t* dev);
+
+/**
+ * Error and recovery counters, accumulated over all buses since boot.
+ */
+typedef struct {
+    uint32_t nack_errors;       // address or data byte not acknowledged
+    uint32_t timeout_errors;    // transaction did not complete in time
+    uint32_t bus_errors;        // arbitration loss, queueing failure, ...
+    uint32_t retries;           // blocking transfers repeated after an error
+    uint32_t bus_resets;        // successful i2c_master_bus_reset() calls
+    uint32_t device_readds;     // device handles replaced after a reset
+    uint32_t recovery_failures; // recoveries that did not succeed
+    uint32_t poll_nacks;        // expected NACKs while polling for a response
+} sensirion_i2c_hal_stats_t;
+
+/**
+ * Copy the current error and recovery counters.
+ */
+void sensirion_i2c_hal_get_stats(sensirion_i2c_hal_stats_t* stats);
+
+/*
+ * Shared buses
+ *
+ * Every device registered with sensirion_i2c_hal_get_device() on a bus, the
+ * SEN66 and any other driver alike, goes through one per-bus lock that is
+ * held for exactly one transaction: from submission until the completion
+ * interrupt, or the transaction timeout. No caller can
+ * hold the bus across transactions, so the hold time is bounded by the
+ * longest transfer (255 bytes, about 23 ms at 100 kHz).
+ *
+ * Waiters are granted the bus by task priority, in arrival order within a
+ * priority, so a high-priority task waits for at most the one transaction in
+ * flight, however many lower-priority drivers share the bus. A waiter gives
+ * up after CONFIG_SEN66_I2C_BUS_WAIT_MS with I2C_BUS_ERROR; a blocking
+ * transfer then recovers the bus, taking it over from a holder whose
+ * completion never arrived.
+ */
+
+/**
+ * Arbitration counters of one bus since sensirion_i2c_hal_init_bus() or the
+ * last sensirion_i2c_hal_reset_bus_stats(). busy_us over the time since
+ * since_us is the bus utilisation.
+ */
+typedef struct {
+    uint32_t transactions;  // bus grants
+    uint32_t contended;     // grants that had to wait for another transaction
+    uint32_t wait_timeouts; // requests that gave up waiting
+    uint32_t takeovers;     // recoveries that took the bus from a stuck holder
+    uint64_t wait_us;       // summed request-to-grant time
+    uint32_t max_wait_us;
+    uint64_t busy_us;       // summed grant-to-completion time
+    uint32_t max_hold_us;
+    int64_t since_us;       // esp_timer time the counters start at
+} sensirion_i2c_hal_bus_stats_t;
+
+/** Bus waits of one device, for checking the latency other devices add. */
+typedef struct {
+    uint32_t transactions;
+    uint64_t wait_us;
+    uint32_t max_wait_us;
+} sensirion_i2c_hal_device_stats_t;
+
+/**
+ * Copy the arbitration counters of a bus.
+ *
+ * @returns 0 on success, I2C_BUS_ERROR if the bus is not initialized
+ */
+int16_t sensirion_i2c_hal_get_bus_stats(uint8_t bus_idx,
+                                        sensirion_i2c_hal_bus_stats_t* stats);
+
+void sensirion_i2c_hal_reset_bus_stats(uint8_t bus_idx);
+
+void sensirion_i2c_hal_get_device_stats(const sensirion_i2c_hal_device_t* dev,
+                                        sensirion_i2c_hal_device_stats_t* stats);
+
+/**
+ * Log one line per initialized bus: utilisation, contention and wait times.
+ */
+void sensirion_i2c_hal_log_bus_stats(void);
+
+/** Latency histogram buckets: bucket i counts [2^i, 2^(i+1)) us, bucket 0
+ * also counts 0 us and the last one everything from 2^(n-1) us up. */
+#define SENSIRION_I2C_HAL_PROFILE_BUCKETS 20
+/** Distinct opcodes tracked; further ones only count as untracked. */
+#define SENSIRION_I2C_HAL_PROFILE_OPCODES 32
+
+/**
+ * Per-opcode bus profile. A transaction belongs to the opcode in its first
+ * two bytes if it is a write, otherwise to the last opcode written to the
+ * same device, so the response reads and NACK polls of a command add up with
+ * the command itself. Every attempt counts, retries included.
+ */
+typedef struct {
+    uint16_t opcode;
+    uint32_t transactions;
+    uint32_t errors;      // transactions that did not end in NO_ERROR
+    uint32_t tx_bytes;
+    uint32_t rx_bytes;    // successfully read only
+    uint64_t bus_us;      // summed start-to-completion latency
+    uint32_t latency[SENSIRION_I2C_HAL_PROFILE_BUCKETS];
+} sensirion_i2c_hal_opcode_profile_t;
+
+typedef struct {
+    sensirion_i2c_hal_opcode_profile_t opcodes[SENSIRION_I2C_HAL_PROFILE_OPCODES];
+    uint8_t opcode_count;
+    uint32_t untracked;   // transactions of opcodes beyond the table
+    uint32_t sleeps;      // sensirion_i2c_hal_sleep_usec() calls
+    uint64_t sleep_us;    // time actually spent in them
+    uint32_t sleep_latency[SENSIRION_I2C_HAL_PROFILE_BUCKETS];
+} sensirion_i2c_hal_profile_t;
+
+/**
+ * Copy the bus profile collected since boot or the last reset. All zero
+ * unless CONFIG_SEN66_I2C_PROFILE is enabled.
+ */
+void sensirion_i2c_hal_get_profile(sensirion_i2c_hal_profile_t* profile);
+
+/**
+ * Running totals of transaction latency and sleep time, for attributing a
+ * measurement cycle without copying the whole profile.
+ */
+void sensirion_i2c_hal_get_time_totals(uint64_t* bus_us, uint64_t* sleep_us);
+
+void sensirion_i2c_hal_reset_profile(void);
+
+/**
+ * Log the profile, one line per opcode with counts and approximate p50/p99.
+ */
+void sensirion_i2c_hal_log_profile(void);
+
 /**
  * Sleep for a given number of microseconds. The function should delay the
  * execution approximately, but no less than, the given time.
@@ -0,0 +1,103 @@
+/*
+ * I2C traffic recorder for the Sensirion HAL.
+ *
+ * With CONFIG_SEN66_I2C_TRACE enabled, every transaction the HAL puts on the
+ * bus (each attempt of a blocking transfer, each poll read and each
+ * asynchronous transfer) is stored in a fixed-size ring, allocated in PSRAM
+ * when available. Writers claim slots with a single atomic increment and
+ * never block, so recording is safe from tasks and from the transaction-done
+ * interrupt alike; once the ring is full the oldest transactions are
+ * overwritten.
+ *
+ * sensirion_i2c_trace_export() streams the ring as a compact binary trace:
+ * one sensirion_i2c_trace_file_header_t followed by records until the end of
+ * the stream, each a sensirion_i2c_trace_record_t followed by `length` data
+ * bytes. All fields are little-endian. The host build replays such a trace
+ * through the driver (see components/sen66/host/include/sen66_replay.h).
+ *
+ * Without CONFIG_SEN66_I2C_TRACE the HAL records nothing and the functions
+ * below are empty.
+ */
+
+#ifndef SENSIRION_I2C_TRACE_H
+#define SENSIRION_I2C_TRACE_H
+
+#include "sensirion_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SENSIRION_I2C_TRACE_MAGIC 0x54363653u /* "S66T" */
+#define SENSIRION_I2C_TRACE_VERSION 1
+/* Longest transfer stored completely; the SEN66 frame buffer size. */
+#define SENSIRION_I2C_TRACE_MAX_DATA 48
+
+typedef enum {
+    SENSIRION_I2C_TRACE_WRITE = 0,
+    SENSIRION_I2C_TRACE_READ = 1,
+    SENSIRION_I2C_TRACE_POLL_READ = 2, /* single attempt, NACK expected */
+} sensirion_i2c_trace_dir_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;       /* SENSIRION_I2C_TRACE_MAGIC */
+    uint16_t version;     /* SENSIRION_I2C_TRACE_VERSION */
+    uint16_t record_size; /* sizeof(sensirion_i2c_trace_record_t) */
+    uint32_t dropped;     /* transactions overwritten before the export */
+} sensirion_i2c_trace_file_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp_us; /* start, esp_timer time truncated to 32 bits */
+    uint32_t duration_us;  /* until completion, error or timeout */
+    uint8_t bus_idx;
+    uint8_t address;
+    uint8_t dir;           /* sensirion_i2c_trace_dir_t */
+    int8_t status;         /* NO_ERROR, I2C_NACK_ERROR or I2C_BUS_ERROR */
+    uint8_t count;         /* bytes requested */
+    uint8_t length;        /* data bytes stored: the written bytes, or the
+                              received ones if the read succeeded */
+} sensirion_i2c_trace_record_t;
+
+/**
+ * sensirion_i2c_trace_init() - Allocate the ring. Called by the HAL when the
+ * first bus comes up; safe to call more than once.
+ */
+void sensirion_i2c_trace_init(void);
+
+/**
+ * sensirion_i2c_trace_record() - Store one transaction. Callable from
+ * interrupt context; does nothing before sensirion_i2c_trace_init().
+ *
+ * @param data Bytes written, or the receive buffer of a read
+ */
+void sensirion_i2c_trace_record(uint8_t bus_idx, uint8_t address,
+                                sensirion_i2c_trace_dir_t dir,
+                                const uint8_t* data, uint8_t count,
+                                int8_t status, uint32_t timestamp_us,
+                                uint32_t duration_us);
+
+/**
+ * Receives the exported trace in pieces. Returns false to stop the export.
+ */
+typedef bool (*sensirion_i2c_trace_sink_t)(const void* data, size_t length,
+                                           void* arg);
+
+/**
+ * sensirion_i2c_trace_export() - Stream the recorded transactions, oldest
+ * first, to sink. Recording continues meanwhile; slots overwritten during
+ * the export are skipped.
+ *
+ * @return Number of records written
+ */
+uint32_t sensirion_i2c_trace_export(sensirion_i2c_trace_sink_t sink,
+                                    void* arg);
+
+/**
+ * sensirion_i2c_trace_clear() - Forget everything recorded so far.
+ */
+void sensirion_i2c_trace_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // SENSIRION_I2C_TRACE_H
@@ -0,0 +1,276 @@
+#include "sen66_async.h"
+#include "sensirion_common.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "sen66_async";
+
+// Lead a maintenance lease must have on the reserved slot; covers a short
+// command and its transfers at 100 kHz.
+#define SEN66_ASYNC_GAP_MARGIN_US (10 * 1000)
+
+typedef struct {
+    uint8_t priority;            // sen66_async_priority_t
+    int64_t deadline_us;         // grant by then or give up, 0 = none
+    int64_t submitted_us;
+    uint32_t seq;                // submission order within a priority
+    bool deferred;               // already counted in stats.deferred
+    SemaphoreHandle_t granted;   // given once the waiter holds the bus
+    volatile int16_t* result;    // where the waiter finds the outcome
+} sen66_async_entry_t;
+
+// Unordered; sen66_async_dispatch() picks the next entry.
+static sen66_async_entry_t queue[SEN66_ASYNC_QUEUE_LENGTH];
+static uint8_t queue_count = 0;
+static uint32_t next_seq = 0;
+static bool busy = false;
+static int64_t reserve_start_us = 0;
+static int64_t reserve_end_us = 0;
+static int64_t hold_until_us = 0;    // a measurement is retrying for the bus
+static sen66_async_stats_t stats;
+static portMUX_TYPE queue_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_timer_handle_t gap_timer = NULL;
+
+static void sen66_async_dispatch(void);
+
+/* esp_timer task: a reserved slot or a hold has passed. */
+static void sen66_async_on_gap(void* arg) {
+    (void)arg;
+    sen66_async_dispatch();
+}
+
+/* Called with queue_lock held. */
+static void sen66_async_account_start(uint8_t priority, int64_t waited_us) {
+    sen66_async_queue_stats_t* s = &stats.priority[priority];
+
+    if (waited_us < 0)
+        waited_us = 0;
+    s->started++;
+    s->wait_us += (uint64_t)waited_us;
+    if (waited_us > s->max_wait_us)
+        s->max_wait_us = waited_us > UINT32_MAX ? UINT32_MAX : (uint32_t)waited_us;
+}
+
+/*
+ * Called with queue_lock held. Maintenance must neither delay a measurement
+ * that is retrying for the bus nor run into the reserved slot; if it would,
+ * *wake_us is lowered to the time it may start.
+ */
+static bool sen66_async_may_start(sen66_async_entry_t* entry, int64_t now,
+                                  int64_t* wake_us) {
+    int64_t until = 0;
+
+    if (entry->priority == SEN66_ASYNC_PRIORITY_MEASUREMENT)
+        return true;
+
+    if (now < hold_until_us)
+        until = hold_until_us;
+    if (now < reserve_end_us &&
+        now + SEN66_ASYNC_GAP_MARGIN_US > reserve_start_us &&
+        reserve_end_us > until)
+        until = reserve_end_us;
+    if (until == 0)
+        return true;
+
+    if (!entry->deferred) {
+        entry->deferred = true;
+        stats.deferred++;
+    }
+    // Wake up at the deadline too, so an expired lease is reported on time.
+    if (entry->deadline_us != 0 && entry->deadline_us < until)
+        until = entry->deadline_us + 1;
+    if (*wake_us == 0 || until < *wake_us)
+        *wake_us = until;
+    return false;
+}
+
+/*
+ * Grant the bus to the most urgent eligible waiter unless it is held. Runs in
+ * whichever context freed the bus or queued a waiter; the claim itself
+ * happens under queue_lock.
+ */
+static void sen66_async_dispatch(void) {
+    sen66_async_entry_t expired[SEN66_ASYNC_QUEUE_LENGTH];
+    sen66_async_entry_t next;
+    uint8_t expired_count = 0;
+    int64_t wake_us = 0;
+    int best = -1;
+    const int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&queue_lock);
+    if (busy) {
+        portEXIT_CRITICAL(&queue_lock);
+        return;
+    }
+
+    for (uint8_t i = 0; i < queue_count;) {
+        sen66_async_entry_t* entry = &queue[i];
+        if (entry->deadline_us != 0 && now > entry->deadline_us) {
+            stats.priority[entry->priority].expired++;
+            expired[expired_count++] = *entry;
+            queue[i] = queue[--queue_count];
+            continue;
+        }
+        if (sen66_async_may_start(entry, now, &wake_us) &&
+            (best < 0 || entry->priority < queue[best].priority ||
+             (entry->priority == queue[best].priority &&
+              (int32_t)(entry->seq - queue[best].seq) < 0)))
+            best = i;
+        i++;
+    }
+
+    if (best >= 0) {
+        next = queue[best];
+        queue[best] = queue[--queue_count];
+        sen66_async_account_start(next.priority, now - next.submitted_us);
+        busy = true;
+    }
+    portEXIT_CRITICAL(&queue_lock);
+
+    for (uint8_t i = 0; i < expired_count; i++) {
+        *expired[i].result = SEN66_ASYNC_DEADLINE_ERROR;
+        xSemaphoreGive(expired[i].granted);
+    }
+
+    if (best < 0) {
+        if (wake_us != 0) {
+            esp_timer_stop(gap_timer);
+            esp_timer_start_once(gap_timer, wake_us > now ? wake_us - now : 1);
+        }
+        return;
+    }
+
+    *next.result = NO_ERROR;
+    xSemaphoreGive(next.granted);
+}
+
+int16_t sen66_async_init(void) {
+    if (gap_timer != NULL)
+        return NO_ERROR;
+
+    esp_timer_create_args_t gap_args = {
+        .callback = &sen66_async_on_gap,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "sen66_async_gap",
+    };
+    if (esp_timer_create(&gap_args, &gap_timer) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create gap timer");
+        return SEN66_ASYNC_NOT_INITIALIZED_ERROR;
+    }
+    return NO_ERROR;
+}
+
+/*
+ * Called with queue_lock held. Drops the waiter's entry if it is still
+ * queued; false means it was granted or expired meanwhile.
+ */
+static bool sen66_async_withdraw(SemaphoreHandle_t granted) {
+    for (uint8_t i = 0; i < queue_count; i++) {
+        if (queue[i].granted == granted) {
+            stats.priority[queue[i].priority].expired++;
+            queue[i] = queue[--queue_count];
+            return true;
+        }
+    }
+    return false;
+}
+
+int16_t sen66_async_acquire(uint8_t priority, int64_t deadline_us) {
+    StaticSemaphore_t granted_buffer;
+    SemaphoreHandle_t granted = xSemaphoreCreateBinaryStatic(&granted_buffer);
+    volatile int16_t result = NO_ERROR;
+    const int64_t now = esp_timer_get_time();
+    const int64_t until = deadline_us != 0 ? deadline_us
+                                           : now + SEN66_ASYNC_ACQUIRE_TIMEOUT_US;
+
+    if (gap_timer == NULL)
+        return SEN66_ASYNC_NOT_INITIALIZED_ERROR;
+
+    portENTER_CRITICAL(&queue_lock);
+    if (queue_count == SEN66_ASYNC_QUEUE_LENGTH) {
+        portEXIT_CRITICAL(&queue_lock);
+        return SEN66_ASYNC_QUEUE_FULL_ERROR;
+    }
+    sen66_async_entry_t* entry = &queue[queue_count++];
+    entry->priority = priority < SEN66_ASYNC_PRIORITY_COUNT
+                          ? priority
+                          : SEN66_ASYNC_PRIORITY_COUNT - 1;
+    entry->deadline_us = deadline_us;
+    entry->submitted_us = now;
+    entry->seq = next_seq++;
+    entry->deferred = false;
+    entry->granted = granted;
+    entry->result = &result;
+    portEXIT_CRITICAL(&queue_lock);
+
+    sen66_async_dispatch();
+
+    // Dispatch only runs when the bus is freed, so a holder that never
+    // releases it would leave the entry waiting; the task times itself out,
+    // rounded up to the next tick.
+    const int64_t wait_us = until > now ? until - now : 0;
+    const TickType_t tick_us = portTICK_PERIOD_MS * 1000;
+    if (xSemaphoreTake(granted, (TickType_t)((wait_us + tick_us - 1) / tick_us)) == pdTRUE)
+        return result;
+
+    portENTER_CRITICAL(&queue_lock);
+    const bool withdrawn = sen66_async_withdraw(granted);
+    portEXIT_CRITICAL(&queue_lock);
+    if (withdrawn)
+        return deadline_us != 0 ? SEN66_ASYNC_DEADLINE_ERROR : SEN66_ASYNC_TIMEOUT_ERROR;
+
+    // Dispatch claimed the entry just now and gives the semaphore right
+    // after leaving the lock.
+    xSemaphoreTake(granted, portMAX_DELAY);
+    return result;
+}
+
+int16_t sen66_async_try_acquire(uint8_t priority, int64_t requested_us) {
+    const int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&queue_lock);
+    if (busy) {
+        if (priority == SEN66_ASYNC_PRIORITY_MEASUREMENT)
+            hold_until_us = now + SEN66_ASYNC_HOLD_US;
+        portEXIT_CRITICAL(&queue_lock);
+        return SEN66_ASYNC_BUSY_ERROR;
+    }
+    busy = true;
+    hold_until_us = 0;
+    if (priority >= SEN66_ASYNC_PRIORITY_COUNT)
+        priority = SEN66_ASYNC_PRIORITY_COUNT - 1;
+    sen66_async_account_start(priority, now - requested_us);
+    portEXIT_CRITICAL(&queue_lock);
+    return NO_ERROR;
+}
+
+void sen66_async_release(void) {
+    portENTER_CRITICAL(&queue_lock);
+    const bool held = busy;
+    busy = false;
+    portEXIT_CRITICAL(&queue_lock);
+
+    if (!held) {
+        ESP_LOGW(TAG, "Release without holding the bus");
+        return;
+    }
+    sen66_async_dispatch();
+}
+
+void sen66_async_reserve(int64_t start_us, uint32_t duration_us) {
+    portENTER_CRITICAL(&queue_lock);
+    reserve_start_us = start_us;
+    reserve_end_us = start_us + duration_us;
+    portEXIT_CRITICAL(&queue_lock);
+}
+
+void sen66_async_get_stats(sen66_async_stats_t* out) {
+    portENTER_CRITICAL(&queue_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&queue_lock);
+}
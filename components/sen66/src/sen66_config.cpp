@@ -0,0 +1,215 @@
+#include "sen66_config.h"
+#include "sen6x_traits.h"
+#include "sensirion_common.h"
+
+#include <esp_log.h>
+#include <esp_rom_crc.h>
+#include <nvs.h>
+#include <cstdio>
+
+static const char *TAG = "SEN66_CONFIG";
+static const char *NVS_NAMESPACE = "sen66";
+static constexpr uint16_t CONFIG_VERSION = 1; // bump when the hashed layout changes
+
+static constexpr sen66_algorithm_tuning_t VOC_DEFAULTS = {100, 12, 12, 180, 50, 230};
+static constexpr sen66_algorithm_tuning_t NOX_DEFAULTS = {1, 12, 12, 720, 50, 230};
+
+sen66_config_t sen66_default_config() {
+    sen66_config_t config = {};
+    config.voc_tuning = VOC_DEFAULTS;
+    config.nox_tuning = NOX_DEFAULTS;
+    config.co2_asc_enabled = true;
+    return config;
+}
+
+static bool tuning_equal(const sen66_algorithm_tuning_t &a, const sen66_algorithm_tuning_t &b) {
+    return a.index_offset == b.index_offset &&
+           a.learning_time_offset_hours == b.learning_time_offset_hours &&
+           a.learning_time_gain_hours == b.learning_time_gain_hours &&
+           a.gating_max_duration_minutes == b.gating_max_duration_minutes &&
+           a.std_initial == b.std_initial && a.gain_factor == b.gain_factor;
+}
+
+static void tuning_words(const sen66_algorithm_tuning_t &t, uint16_t *out) {
+    out[0] = t.index_offset;
+    out[1] = t.learning_time_offset_hours;
+    out[2] = t.learning_time_gain_hours;
+    out[3] = t.gating_max_duration_minutes;
+    out[4] = t.std_initial;
+    out[5] = t.gain_factor;
+}
+
+// Hashes the fields one by one; the struct itself has padding.
+static uint32_t config_hash(const sen66_config_t &config) {
+    uint16_t words[19] = {
+        CONFIG_VERSION,
+        config.altitude_m,
+        uint16_t(config.temperature_offset),
+        uint16_t(config.temperature_slope),
+        config.temperature_time_constant,
+        config.temperature_slot,
+        config.co2_asc_enabled,
+    };
+    tuning_words(config.voc_tuning, &words[7]);
+    tuning_words(config.nox_tuning, &words[13]);
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t *>(words), sizeof(words));
+}
+
+static void nvs_key(const sen66_ctx_t *ctx, char *key, size_t size) {
+    snprintf(key, size, "cfg%u_%02x", ctx->bus_idx, ctx->i2c_address);
+}
+
+static uint32_t load_hash(const sen66_ctx_t *ctx) {
+    uint32_t hash = 0;
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK)
+        return 0;
+    char key[16];
+    nvs_key(ctx, key, sizeof(key));
+    if (nvs_get_u32(handle, key, &hash) != ESP_OK)
+        hash = 0;
+    nvs_close(handle);
+    return hash;
+}
+
+static void store_hash(const sen66_ctx_t *ctx, uint32_t hash) {
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to open NVS namespace");
+        return;
+    }
+    char key[16];
+    nvs_key(ctx, key, sizeof(key));
+    esp_err_t err = nvs_set_u32(handle, key, hash);
+    if (err == ESP_OK)
+        err = nvs_commit(handle);
+    if (err != ESP_OK)
+        ESP_LOGW(TAG, "Failed to write config hash to NVS (%d)", err);
+    nvs_close(handle);
+}
+
+static int16_t set_tuning(sen66_ctx_t *ctx, bool voc, const sen66_algorithm_tuning_t &t) {
+    auto set = voc ? sen66_set_voc_algorithm_tuning_parameters : sen66_set_nox_algorithm_tuning_parameters;
+    return set(ctx, t.index_offset, t.learning_time_offset_hours, t.learning_time_gain_hours,
+               t.gating_max_duration_minutes, t.std_initial, t.gain_factor);
+}
+
+static int16_t get_tuning(sen66_ctx_t *ctx, bool voc, sen66_algorithm_tuning_t *t) {
+    auto get = voc ? sen66_get_voc_algorithm_tuning_parameters : sen66_get_nox_algorithm_tuning_parameters;
+    return get(ctx, &t->index_offset, &t->learning_time_offset_hours, &t->learning_time_gain_hours,
+               &t->gating_max_duration_minutes, &t->std_initial, &t->gain_factor);
+}
+
+// Settings of channels the module lacks are neither read nor written; they
+// keep the values passed in.
+static constexpr bool kHasAltitude = sen6x::Active::has(sen6x::CO2); // altitude and ASC: CO2 modules
+static constexpr bool kHasVoc = sen6x::Active::has(sen6x::VOC_INDEX);
+static constexpr bool kHasNox = sen6x::Active::has(sen6x::NOX_INDEX);
+// Whether the module has an idle-only getter to tell idle from measuring.
+static constexpr bool kSettingsReadable = kHasAltitude || kHasVoc || kHasNox;
+
+static int16_t read_settings(sen66_ctx_t *ctx, uint16_t *altitude, sen66_algorithm_tuning_t *voc,
+                             sen66_algorithm_tuning_t *nox, bool *asc) {
+    int16_t ret = NO_ERROR;
+    if constexpr (kHasAltitude) {
+        uint8_t padding;
+        if ((ret = sen66_get_sensor_altitude(ctx, altitude)) != NO_ERROR ||
+            (ret = sen66_get_co2_sensor_automatic_self_calibration(ctx, &padding, asc)) != NO_ERROR)
+            return ret;
+    }
+    if constexpr (kHasVoc) {
+        if ((ret = get_tuning(ctx, true, voc)) != NO_ERROR)
+            return ret;
+    }
+    if constexpr (kHasNox) {
+        if ((ret = get_tuning(ctx, false, nox)) != NO_ERROR)
+            return ret;
+    }
+    return ret;
+}
+
+int16_t sen66_apply_config(sen66_ctx_t *ctx, const sen66_config_t *config, bool *measuring) {
+    const sen66_config_t defaults = sen66_default_config();
+    const uint32_t hash = config_hash(*config);
+    const bool recorded = load_hash(ctx) == hash;
+    *measuring = false;
+
+    // Every module answers get_version in either mode.
+    uint8_t major, minor;
+    int16_t ret = sen66_get_version(ctx, &major, &minor);
+    if (ret != NO_ERROR)
+        return ret; // not answering at all
+
+    // The getters are idle-only, so failing to read the settings means the
+    // sensor kept running (and kept its settings) across our reset. A module
+    // without readable settings (SEN62) cannot tell and is always stopped.
+    uint16_t altitude = config->altitude_m;
+    sen66_algorithm_tuning_t voc = config->voc_tuning, nox = config->nox_tuning;
+    bool asc = config->co2_asc_enabled;
+    ret = read_settings(ctx, &altitude, &voc, &nox, &asc);
+    if (ret != NO_ERROR || !kSettingsReadable) {
+        if (kSettingsReadable && recorded) {
+            ESP_LOGI(TAG, "Sensor still measuring with the recorded configuration");
+            *measuring = true;
+            return NO_ERROR;
+        }
+        ESP_LOGI(TAG, "Sensor possibly measuring with an unknown configuration; stopping it");
+        ret = sen66_stop_measurement(ctx);
+        if (ret == NO_ERROR)
+            ret = read_settings(ctx, &altitude, &voc, &nox, &asc);
+        if (ret != NO_ERROR)
+            return ret;
+    }
+
+    // Settings away from their power-on value prove the sensor has not been
+    // reset since they were written, and so neither has the temperature offset.
+    const bool altitudeMatches = altitude == config->altitude_m;
+    const bool vocMatches = tuning_equal(voc, config->voc_tuning);
+    const bool noxMatches = tuning_equal(nox, config->nox_tuning);
+    const bool ascMatches = asc == config->co2_asc_enabled;
+    const bool readBackMatches = altitudeMatches && vocMatches && noxMatches && ascMatches;
+    const bool readBackNonDefault = (kHasAltitude && (altitude != defaults.altitude_m ||
+                                                      asc != defaults.co2_asc_enabled)) ||
+                                    (kHasVoc && !tuning_equal(voc, defaults.voc_tuning)) ||
+                                    (kHasNox && !tuning_equal(nox, defaults.nox_tuning));
+    const bool offsetDefault = config->temperature_offset == 0 && config->temperature_slope == 0 &&
+                               config->temperature_time_constant == 0;
+    const bool offsetKept = offsetDefault || (recorded && readBackMatches && readBackNonDefault);
+
+    unsigned writes = 0;
+    if (!altitudeMatches) {
+        ret = sen66_set_sensor_altitude(ctx, config->altitude_m);
+        writes++;
+    }
+    if (ret == NO_ERROR && !vocMatches) {
+        ret = set_tuning(ctx, true, config->voc_tuning);
+        writes++;
+    }
+    if (ret == NO_ERROR && !noxMatches) {
+        ret = set_tuning(ctx, false, config->nox_tuning);
+        writes++;
+    }
+    if (ret == NO_ERROR && !ascMatches) {
+        ret = sen66_set_co2_sensor_automatic_self_calibration(ctx, config->co2_asc_enabled);
+        writes++;
+    }
+    if (ret == NO_ERROR && !offsetKept) {
+        ret = sen66_set_temperature_offset_parameters(ctx, config->temperature_offset,
+                                                      config->temperature_slope,
+                                                      config->temperature_time_constant,
+                                                      config->temperature_slot);
+        writes++;
+    }
+    if (ret != NO_ERROR) {
+        ESP_LOGE(TAG, "Applying the sensor configuration failed: %d", ret);
+        return ret;
+    }
+
+    if (!recorded)
+        store_hash(ctx, hash);
+    if constexpr (kHasAltitude)
+        ESP_LOGI(TAG, "Configuration applied (altitude %u m), %u setting(s) written", config->altitude_m, writes);
+    else
+        ESP_LOGI(TAG, "Configuration applied, %u setting(s) written", writes);
+    return NO_ERROR;
+}
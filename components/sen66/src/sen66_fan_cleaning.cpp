@@ -0,0 +1,143 @@
+#include "sen66_fan_cleaning.h"
+#include "sensirion_common.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <nvs.h>
+#include <cstdio>
+#include <ctime>
+
+static const char *TAG = "SEN66_FAN_CLEANING";
+static const char *NVS_NAMESPACE = "sen66";
+static constexpr uint32_t RETRY_S = 60 * 60; // after a failed attempt
+
+static void nvs_key(const sen66_ctx_t *ctx, char *key, size_t size) {
+    snprintf(key, size, "fan%u_%02x", ctx->bus_idx, ctx->i2c_address);
+}
+
+static uint32_t load_epoch(const sen66_ctx_t *ctx) {
+    uint32_t epoch = 0;
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK)
+        return 0;
+    char key[16];
+    nvs_key(ctx, key, sizeof(key));
+    if (nvs_get_u32(handle, key, &epoch) != ESP_OK)
+        epoch = 0;
+    nvs_close(handle);
+    return epoch;
+}
+
+static void store_epoch(const sen66_ctx_t *ctx, uint32_t epoch) {
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to open NVS namespace");
+        return;
+    }
+    char key[16];
+    nvs_key(ctx, key, sizeof(key));
+    esp_err_t err = nvs_set_u32(handle, key, epoch);
+    if (err == ESP_OK)
+        err = nvs_commit(handle);
+    if (err != ESP_OK)
+        ESP_LOGW(TAG, "Failed to write cleaning time to NVS (%d)", err);
+    nvs_close(handle);
+}
+
+Sen66FanCleaning::Sen66FanCleaning(sen66_ctx_t *ctx, uint32_t periodDays, uint8_t windowStartHour,
+                                   uint8_t windowHours)
+    : mCtx(ctx),
+      mPeriodS(periodDays * 24 * 60 * 60),
+      mWindowStartHour(windowStartHour % 24),
+      mWindowHours(windowHours ? windowHours : 1)
+{
+}
+
+bool Sen66FanCleaning::onCycle()
+{
+    const int64_t now = esp_timer_get_time();
+    switch (mStage) {
+    case Stage::Idle:
+        if (due())
+            start(now, uint32_t(time(nullptr)));
+        return mStage != Stage::Cleaning;
+    case Stage::Cleaning:
+        if (now < mCleanEndUs)
+            return false;
+        finish(now);
+        return true;
+    case Stage::Settling:
+        if (now >= mBlankEndUs)
+            mStage = Stage::Idle;
+        return true;
+    }
+    return true;
+}
+
+bool Sen66FanCleaning::pmBlanked(int64_t nowUs) const
+{
+    return mStage != Stage::Idle && nowUs < mBlankEndUs;
+}
+
+bool Sen66FanCleaning::due()
+{
+    if (mPeriodS == 0)
+        return false;
+
+    const time_t now = time(nullptr);
+    struct tm local;
+    localtime_r(&now, &local);
+    if (local.tm_year < (2016 - 1900)) {
+        if (!mClockLogged)
+            ESP_LOGI(TAG, "Wall clock not set yet; fan cleaning waits for SNTP");
+        mClockLogged = true;
+        return false;
+    }
+    if (!mLoaded) {
+        mLastEpoch = load_epoch(mCtx);
+        mLoaded = true;
+    }
+
+    const uint32_t epoch = uint32_t(now);
+    if (epoch < mRetryEpoch)
+        return false;
+    const unsigned windowHour = (local.tm_hour + 24 - mWindowStartHour) % 24;
+    if (windowHour >= mWindowHours)
+        return false;
+    // One window of slack, so the cleaning does not slip later every period.
+    // A record from the future (clock set wrong back then) counts as overdue.
+    const int64_t elapsed = int64_t(epoch) - mLastEpoch;
+    return mLastEpoch == 0 || elapsed < 0 || elapsed + int64_t(mWindowHours) * 60 * 60 >= mPeriodS;
+}
+
+void Sen66FanCleaning::start(int64_t nowUs, uint32_t epoch)
+{
+    // Stopping fails if the sensor is idle already; cleaning is allowed then.
+    sen66_stop_measurement(mCtx);
+    int16_t ret = sen66_start_fan_cleaning(mCtx);
+    if (ret != NO_ERROR) {
+        ESP_LOGW(TAG, "Fan cleaning failed to start (%d); retrying in an hour", ret);
+        mRetryEpoch = epoch + RETRY_S;
+        finish(nowUs);
+        return;
+    }
+
+    mCleanEndUs = esp_timer_get_time() + kCleaningUs;
+    mBlankEndUs = mCleanEndUs + kSettleUs;
+    mStage = Stage::Cleaning;
+    mLastEpoch = epoch;
+    mCleanings++;
+    store_epoch(mCtx, epoch);
+    ESP_LOGI(TAG, "Fan cleaning started; PM blanked for %lld s",
+             (long long)((mBlankEndUs - nowUs) / (1000 * 1000)));
+}
+
+void Sen66FanCleaning::finish(int64_t nowUs)
+{
+    // A failed start is left to the supervisor, which sees the reads fail.
+    int16_t ret = sen66_start_continuous_measurement(mCtx);
+    if (ret != NO_ERROR)
+        ESP_LOGW(TAG, "Restarting the measurement after fan cleaning failed: %d", ret);
+    mBlankEndUs = nowUs + kSettleUs;
+    mStage = Stage::Settling;
+}
@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2025, Sensirion AG
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of Sensirion AG nor the names of its
+ *   contributors may be used to endorse or promote products derived from
+ *   this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sen66_i2c.h"
+#include "sen66_commands.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+#include "sensirion_i2c_hal.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+using sen66::Command;
+namespace cmd = sen66::cmd;
+
+namespace {
+
+// One scheduler tick: the HAL sleeps whole ticks in vTaskDelay() and
+// busy-waits anything shorter.
+constexpr int64_t kTickUs = portTICK_PERIOD_MS * 1000;
+
+// Poll interval within the last tick before the response is due. A NACKed
+// poll holds the bus for one address byte, about 90 us at 100 kHz.
+constexpr int64_t kFinePollUs = 250;
+
+/*
+ * Fetch the response of a command whose execution time ends at ready_by_us.
+ * The sensor NACKs the read until the response is ready, so poll until it
+ * acknowledges: a tick apart while the deadline is further away, so the
+ * task yields, then every kFinePollUs, so the response is never picked up
+ * later than after sleeping the whole execution time. Past the deadline the
+ * last attempt is a regular read with the HAL's retry and recovery handling.
+ */
+int16_t sen66_read_response(sen66_ctx_t* ctx, const Command& command,
+                            int64_t ready_by_us) {
+    uint8_t* buffer_ptr = ctx->communication_buffer;
+    uint16_t size = command.rx_words * (SENSIRION_WORD_SIZE + CRC8_LEN);
+
+    for (;;) {
+        int8_t status =
+            sensirion_i2c_hal_device_poll_read(ctx->device, buffer_ptr, size);
+        if (status == NO_ERROR) {
+            return sensirion_i2c_check_crc_and_compact(buffer_ptr, size);
+        }
+        if (status != I2C_NACK_ERROR) {
+            break;
+        }
+        const int64_t left_us = ready_by_us - esp_timer_get_time();
+        if (left_us <= 0) {
+            break;
+        }
+        sensirion_i2c_hal_sleep_usec(static_cast<uint32_t>(
+            left_us > kTickUs ? kTickUs
+                              : left_us < kFinePollUs ? left_us : kFinePollUs));
+    }
+    return sensirion_i2c_device_read_data_inplace(ctx->device, buffer_ptr,
+                                                  command.rxBytes());
+}
+
+/*
+ * Send the frame already encoded in the context buffer, wait for the command
+ * to execute and read its response back into the buffer. Every command of
+ * the driver ends up here.
+ */
+int16_t sen66_execute(sen66_ctx_t* ctx, const Command& command,
+                      uint16_t tx_length) {
+    int16_t local_error = sensirion_i2c_device_write_data(
+        ctx->device, ctx->communication_buffer, tx_length);
+    if (local_error != NO_ERROR) {
+        return local_error;
+    }
+    if (command.rx_words == 0) {
+        sensirion_i2c_hal_sleep_usec(command.exec_time_us);
+        return NO_ERROR;
+    }
+    const int64_t ready_by_us = esp_timer_get_time() + command.exec_time_us;
+    sensirion_i2c_hal_sleep_usec(command.min_exec_us);
+    return sen66_read_response(ctx, command, ready_by_us);
+}
+
+/*
+ * Encode opcode and word arguments of C and execute it. The argument list is
+ * checked against the descriptor at compile time.
+ */
+template <const Command& C, typename... Args>
+int16_t sen66_run(sen66_ctx_t* ctx, Args... args) {
+    static_assert(sizeof...(Args) == C.tx_words,
+                  "argument count does not match the command descriptor");
+    static_assert(((sizeof(Args) == SENSIRION_WORD_SIZE) && ...),
+                  "command arguments are 16 bit words");
+
+    uint8_t* buffer_ptr = ctx->communication_buffer;
+    uint16_t local_offset =
+        sensirion_i2c_add_command16_to_buffer(buffer_ptr, 0, C.opcode);
+    ((local_offset = sensirion_i2c_add_uint16_t_to_buffer(
+          buffer_ptr, local_offset, static_cast<uint16_t>(args))),
+     ...);
+    return sen66_execute(ctx, C, local_offset);
+}
+
+template <typename T> T sen66_decode(const uint8_t* bytes);
+
+template <> uint8_t sen66_decode<uint8_t>(const uint8_t* bytes) {
+    return bytes[0];
+}
+
+template <> bool sen66_decode<bool>(const uint8_t* bytes) {
+    return bytes[0] != 0;
+}
+
+template <> uint16_t sen66_decode<uint16_t>(const uint8_t* bytes) {
+    return sensirion_common_bytes_to_uint16_t(bytes);
+}
+
+template <> int16_t sen66_decode<int16_t>(const uint8_t* bytes) {
+    return sensirion_common_bytes_to_int16_t(bytes);
+}
+
+template <> uint32_t sen66_decode<uint32_t>(const uint8_t* bytes) {
+    return sensirion_common_bytes_to_uint32_t(bytes);
+}
+
+/*
+ * Split the response of C into the output fields, in order. The field sizes
+ * must add up to the response length of the descriptor.
+ */
+template <const Command& C, typename... Out>
+void sen66_unpack(const sen66_ctx_t* ctx, Out*... out) {
+    static_assert((sizeof(Out) + ... + 0) == C.rxBytes(),
+                  "output fields do not match the command response");
+
+    const uint8_t* buffer_ptr = ctx->communication_buffer;
+    uint16_t local_offset = 0;
+    ((*out = sen66_decode<Out>(&buffer_ptr[local_offset]),
+      local_offset += sizeof(Out)),
+     ...);
+}
+
+/*
+ * Execute C and decode its response into the output fields.
+ */
+template <const Command& C, typename... Out>
+int16_t sen66_query(sen66_ctx_t* ctx, Out*... out) {
+    int16_t local_error = sen66_run<C>(ctx);
+    if (local_error != NO_ERROR) {
+        return local_error;
+    }
+    sen66_unpack<C>(ctx, out...);
+    return NO_ERROR;
+}
+
+/*
+ * Execute C and copy at most size bytes of its response to destination.
+ */
+template <const Command& C>
+int16_t sen66_query_bytes(sen66_ctx_t* ctx, uint8_t* destination,
+                          uint16_t size) {
+    int16_t local_error = sen66_run<C>(ctx);
+    if (local_error != NO_ERROR) {
+        return local_error;
+    }
+    if (size > C.rxBytes()) {
+        size = C.rxBytes();
+    }
+    sensirion_common_copy_bytes(ctx->communication_buffer, destination, size);
+    return NO_ERROR;
+}
+
+}  // namespace
+
+int16_t sen66::read_words(sen66_ctx_t* ctx, const Command& command,
+                          uint16_t* words) {
+    uint16_t local_offset = sensirion_i2c_add_command16_to_buffer(
+        ctx->communication_buffer, 0, command.opcode);
+    int16_t local_error = sen66_execute(ctx, command, local_offset);
+    if (local_error != NO_ERROR) {
+        return local_error;
+    }
+    for (uint8_t i = 0; i < command.rx_words; i++) {
+        words[i] = sen66_decode<uint16_t>(
+            &ctx->communication_buffer[i * SENSIRION_WORD_SIZE]);
+    }
+    return NO_ERROR;
+}
+
+void sen66_init(sen66_ctx_t* ctx, uint8_t bus_idx, uint8_t i2c_address) {
+    ctx->bus_idx = bus_idx;
+    ctx->i2c_address = i2c_address;
+    ctx->device = sensirion_i2c_hal_get_device(bus_idx, i2c_address);
+}
+
+uint16_t sen66_signal_co2(uint16_t co2_raw) {
+    uint16_t co2 = 0;
+    co2 = co2_raw;
+    return co2;
+}
+
+int16_t sen66_start_continuous_measurement(sen66_ctx_t* ctx) {
+    return sen66_run<cmd::start_continuous_measurement>(ctx);
+}
+
+int16_t sen66_stop_measurement(sen66_ctx_t* ctx) {
+    return sen66_run<cmd::stop_measurement>(ctx);
+}
+
+int16_t sen66_get_data_ready(sen66_ctx_t* ctx, uint8_t* padding,
+                             bool* data_ready) {
+    return sen66_query<cmd::get_data_ready>(ctx, padding, data_ready);
+}
+
+int16_t sen66_read_measured_values_as_integers(
+    sen66_ctx_t* ctx, uint16_t* mass_concentration_pm1p0,
+    uint16_t* mass_concentration_pm2p5, uint16_t* mass_concentration_pm4p0,
+    uint16_t* mass_concentration_pm10p0, int16_t* ambient_humidity,
+    int16_t* ambient_temperature, int16_t* voc_index, int16_t* nox_index,
+    uint16_t* co2) {
+    return sen66_query<cmd::read_measured_values_as_integers>(
+        ctx, mass_concentration_pm1p0, mass_concentration_pm2p5,
+        mass_concentration_pm4p0, mass_concentration_pm10p0, ambient_humidity,
+        ambient_temperature, voc_index, nox_index, co2);
+}
+
+int16_t sen66_read_number_concentration_values_as_integers(
+    sen66_ctx_t* ctx, uint16_t* number_concentration_pm0p5,
+    uint16_t* number_concentration_pm1p0, uint16_t* number_concentration_pm2p5,
+    uint16_t* number_concentration_pm4p0,
+    uint16_t* number_concentration_pm10p0) {
+    return sen66_query<cmd::read_number_concentration_values>(
+        ctx, number_concentration_pm0p5, number_concentration_pm1p0,
+        number_concentration_pm2p5, number_concentration_pm4p0,
+        number_concentration_pm10p0);
+}
+
+int16_t sen66_read_measured_raw_values(sen66_ctx_t* ctx, int16_t* raw_humidity,
+                                       int16_t* raw_temperature,
+                                       uint16_t* raw_voc, uint16_t* raw_nox,
+                                       uint16_t* raw_co2) {
+    return sen66_query<cmd::read_measured_raw_values>(
+        ctx, raw_humidity, raw_temperature, raw_voc, raw_nox, raw_co2);
+}
+
+int16_t sen66_start_fan_cleaning(sen66_ctx_t* ctx) {
+    return sen66_run<cmd::start_fan_cleaning>(ctx);
+}
+
+int16_t sen66_set_temperature_offset_parameters(sen66_ctx_t* ctx,
+                                                int16_t offset, int16_t slope,
+                                                uint16_t time_constant,
+                                                uint16_t slot) {
+    return sen66_run<cmd::set_temperature_offset_parameters>(
+        ctx, offset, slope, time_constant, slot);
+}
+
+int16_t sen66_set_voc_algorithm_tuning_parameters(
+    sen66_ctx_t* ctx, int16_t index_offset, int16_t learning_time_offset_hours,
+    int16_t learning_time_gain_hours, int16_t gating_max_duration_minutes,
+    int16_t std_initial, int16_t gain_factor) {
+    return sen66_run<cmd::set_voc_algorithm_tuning_parameters>(
+        ctx, index_offset, learning_time_offset_hours,
+        learning_time_gain_hours, gating_max_duration_minutes, std_initial,
+        gain_factor);
+}
+
+int16_t sen66_get_voc_algorithm_tuning_parameters(
+    sen66_ctx_t* ctx, int16_t* index_offset,
+    int16_t* learning_time_offset_hours, int16_t* learning_time_gain_hours,
+    int16_t* gating_max_duration_minutes, int16_t* std_initial,
+    int16_t* gain_factor) {
+    return sen66_query<cmd::get_voc_algorithm_tuning_parameters>(
+        ctx, index_offset, learning_time_offset_hours,
+        learning_time_gain_hours, gating_max_duration_minutes, std_initial,
+        gain_factor);
+}
+
+int16_t sen66_set_nox_algorithm_tuning_parameters(
+    sen66_ctx_t* ctx, int16_t index_offset, int16_t learning_time_offset_hours,
+    int16_t learning_time_gain_hours, int16_t gating_max_duration_minutes,
+    int16_t std_initial, int16_t gain_factor) {
+    return sen66_run<cmd::set_nox_algorithm_tuning_parameters>(
+        ctx, index_offset, learning_time_offset_hours,
+        learning_time_gain_hours, gating_max_duration_minutes, std_initial,
+        gain_factor);
+}
+
+int16_t sen66_get_nox_algorithm_tuning_parameters(
+    sen66_ctx_t* ctx, int16_t* index_offset,
+    int16_t* learning_time_offset_hours, int16_t* learning_time_gain_hours,
+    int16_t* gating_max_duration_minutes, int16_t* std_initial,
+    int16_t* gain_factor) {
+    return sen66_query<cmd::get_nox_algorithm_tuning_parameters>(
+        ctx, index_offset, learning_time_offset_hours,
+        learning_time_gain_hours, gating_max_duration_minutes, std_initial,
+        gain_factor);
+}
+
+int16_t sen66_set_temperature_acceleration_parameters(sen66_ctx_t* ctx,
+                                                      uint16_t k, uint16_t p,
+                                                      uint16_t t1,
+                                                      uint16_t t2) {
+    return sen66_run<cmd::set_temperature_acceleration>(ctx, k, p, t1, t2);
+}
+
+int16_t sen66_set_voc_algorithm_state(sen66_ctx_t* ctx, const uint8_t* state,
+                                      uint16_t state_size) {
+    constexpr const Command& C = cmd::set_voc_algorithm_state;
+    if (state_size != C.tx_words * SENSIRION_WORD_SIZE) {
+        return BYTE_NUM_ERROR;
+    }
+
+    uint8_t* buffer_ptr = ctx->communication_buffer;
+    uint16_t local_offset =
+        sensirion_i2c_add_command16_to_buffer(buffer_ptr, 0, C.opcode);
+    local_offset = sensirion_i2c_add_bytes_to_buffer(buffer_ptr, local_offset,
+                                                     state, state_size);
+    return sen66_execute(ctx, C, local_offset);
+}
+
+int16_t sen66_get_voc_algorithm_state(sen66_ctx_t* ctx, uint8_t* state,
+                                      uint16_t state_size) {
+    return sen66_query_bytes<cmd::get_voc_algorithm_state>(ctx, state,
+                                                           state_size);
+}
+
+int16_t sen66_perform_forced_co2_recalibration(
+    sen66_ctx_t* ctx, uint16_t target_co2_concentration, uint16_t* correction) {
+    constexpr const Command& C = cmd::perform_forced_co2_recalibration;
+    int16_t local_error = sen66_run<C>(ctx, target_co2_concentration);
+    if (local_error != NO_ERROR) {
+        return local_error;
+    }
+    sen66_unpack<C>(ctx, correction);
+    return NO_ERROR;
+}
+
+int16_t sen66_set_co2_sensor_automatic_self_calibration(sen66_ctx_t* ctx,
+                                                        uint16_t status) {
+    return sen66_run<cmd::set_co2_automatic_self_calibration>(ctx, status);
+}
+
+int16_t sen66_get_co2_sensor_automatic_self_calibration(sen66_ctx_t* ctx,
+                                                        uint8_t* padding,
+                                                        bool* status) {
+    return sen66_query<cmd::get_co2_automatic_self_calibration>(ctx, padding,
+                                                                status);
+}
+
+int16_t sen66_set_ambient_pressure(sen66_ctx_t* ctx,
+                                   uint16_t ambient_pressure) {
+    return sen66_run<cmd::set_ambient_pressure>(ctx, ambient_pressure);
+}
+
+int16_t sen66_get_ambient_pressure(sen66_ctx_t* ctx,
+                                   uint16_t* ambient_pressure) {
+    return sen66_query<cmd::get_ambient_pressure>(ctx, ambient_pressure);
+}
+
+int16_t sen66_set_sensor_altitude(sen66_ctx_t* ctx, uint16_t altitude) {
+    return sen66_run<cmd::set_sensor_altitude>(ctx, altitude);
+}
+
+int16_t sen66_get_sensor_altitude(sen66_ctx_t* ctx, uint16_t* altitude) {
+    return sen66_query<cmd::get_sensor_altitude>(ctx, altitude);
+}
+
+int16_t sen66_activate_sht_heater(sen66_ctx_t* ctx) {
+    return sen66_run<cmd::activate_sht_heater>(ctx);
+}
+
+int16_t sen66_get_sht_heater_measurements(sen66_ctx_t* ctx, int16_t* humidity,
+                                          int16_t* temperature) {
+    return sen66_query<cmd::get_sht_heater_measurements>(ctx, humidity,
+                                                         temperature);
+}
+
+int16_t sen66_get_product_name(sen66_ctx_t* ctx, int8_t* product_name,
+                               uint16_t product_name_size) {
+    return sen66_query_bytes<cmd::get_product_name>(
+        ctx, reinterpret_cast<uint8_t*>(product_name), product_name_size);
+}
+
+int16_t sen66_get_serial_number(sen66_ctx_t* ctx, int8_t* serial_number,
+                                uint16_t serial_number_size) {
+    return sen66_query_bytes<cmd::get_serial_number>(
+        ctx, reinterpret_cast<uint8_t*>(serial_number), serial_number_size);
+}
+
+int16_t sen66_get_version(sen66_ctx_t* ctx, uint8_t* firmware_major,
+                          uint8_t* firmware_minor) {
+    return sen66_query<cmd::get_version>(ctx, firmware_major, firmware_minor);
+}
+
+int16_t sen66_read_device_status(sen66_ctx_t* ctx,
+                                 sen66_device_status* device_status) {
+    return sen66_query<cmd::read_device_status>(ctx, &device_status->value);
+}
+
+int16_t sen66_read_and_clear_device_status(sen66_ctx_t* ctx,
+                                           sen66_device_status* device_status) {
+    return sen66_query<cmd::read_and_clear_device_status>(
+        ctx, &device_status->value);
+}
+
+int16_t sen66_device_reset(sen66_ctx_t* ctx) {
+    return sen66_run<cmd::device_reset>(ctx);
+}
@@ -0,0 +1,74 @@
+#include "sen66_phase_lock.h"
+
+// Only edges this many periods apart refine the period; with a bracket of a
+// few ms that keeps the per-update error well below a millisecond.
+static constexpr int64_t MIN_PERIODS_FOR_ESTIMATE = 10;
+// SEN66 clock tolerance is far below this; anything outside is a bad edge.
+static constexpr int64_t MAX_PERIOD_DEVIATION_US = Sen66PhaseLock::kNominalPeriodUs / 50;
+
+int64_t Sen66PhaseLock::nextUpdateUs(int64_t timeUs) const
+{
+    if (timeUs <= mEdgeUs)
+        return mEdgeUs;
+
+    int64_t periods = (timeUs - mEdgeUs + mPeriodUs - 1) / mPeriodUs;
+    return mEdgeUs + periods * mPeriodUs;
+}
+
+int64_t Sen66PhaseLock::nextReadUs(int64_t notBeforeUs) const
+{
+    if (!mLocked)
+        return notBeforeUs;
+
+    return nextUpdateUs(notBeforeUs + kLeadUs) - kLeadUs;
+}
+
+void Sen66PhaseLock::onCleared(int64_t timeUs)
+{
+    mLastNotReadyUs = timeUs;
+}
+
+void Sen66PhaseLock::onDataReady(bool ready, int64_t timeUs)
+{
+    if (!ready) {
+        if (mLocked) {
+            // The update did not come in the predicted window; the phase or
+            // period has drifted. Measure the edge again.
+            mLocked = false;
+            mMisses++;
+        }
+        mLastNotReadyUs = timeUs;
+        return;
+    }
+
+    bool bracketed = mLastNotReadyUs >= 0 && timeUs - mLastNotReadyUs <= kMaxEdgeWindowUs;
+    int64_t edge = (mLastNotReadyUs + timeUs) / 2;
+    mLastNotReadyUs = -1;
+
+    if (!bracketed) {
+        // A locked cycle brackets the update by lead and guard only, which
+        // confirms the prediction but is too wide to improve on it.
+        if (mLocked)
+            mHits++;
+        return;
+    }
+
+    if (!mHaveEdge) {
+        mAnchorUs = edge;
+    } else {
+        int64_t elapsed = edge - mAnchorUs;
+        int64_t periods = (elapsed + mPeriodUs / 2) / mPeriodUs;
+        if (periods >= MIN_PERIODS_FOR_ESTIMATE) {
+            int64_t measured = elapsed / periods;
+            if (measured > kNominalPeriodUs - MAX_PERIOD_DEVIATION_US &&
+                measured < kNominalPeriodUs + MAX_PERIOD_DEVIATION_US)
+                mPeriodUs = (mPeriodUs + measured) / 2;
+            mAnchorUs = edge;
+        }
+    }
+
+    mEdgeUs = edge;
+    mHaveEdge = true;
+    mLocked = true;
+    mLocks++;
+}
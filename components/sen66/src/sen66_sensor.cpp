@@ -1,8 +1,12 @@
 #include "sen66_sensor.h"
 #include "sen66_i2c.h"
+#include "sen66_voc_state.h"
+#include "sen6x_traits.h"
 #include "sensirion_i2c_hal.h"
+#include "sensirion_common.h"
 
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <cmath>
@@ -10,24 +14,101 @@
 static const char *TAG = "SEN66_SENSOR";
 static constexpr TickType_t POLL_PERIOD = pdMS_TO_TICKS(50);
 static constexpr TickType_t MAX_WAIT    = pdMS_TO_TICKS(500);
+static constexpr uint32_t RELOCK_POLL_PERIOD_US = 10 * 1000;
+static constexpr int64_t RELOCK_TIMEOUT_US = 1200 * 1000; // one update period plus margin
+static constexpr int64_t POWER_UP_US = 20 * 1000;          // sensor start-up after power-on
 constexpr uint16_t INVALID_UINT16 = 0xFFFF;
 constexpr int16_t INVALID_INT16 = 0x7FFF;
+constexpr sen66_record_t INVALID_RECORD = {
+    0, 0,
+    INVALID_UINT16, INVALID_UINT16, INVALID_UINT16, INVALID_UINT16,
+    INVALID_INT16, INVALID_INT16, INVALID_INT16, INVALID_INT16, INVALID_UINT16, INVALID_UINT16,
+    INVALID_UINT16, INVALID_UINT16, INVALID_UINT16, INVALID_UINT16, INVALID_UINT16,
+    INVALID_INT16, INVALID_INT16, INVALID_UINT16, INVALID_UINT16, INVALID_UINT16,
+};
+
+static sen66_ctx_t default_ctx;
+
+sen66_ctx_t *sen66_default_ctx() {
+    return &default_ctx;
+}
 
 void sen66_i2c_init(uint16_t sensorAltitudeM) {
     sensirion_i2c_hal_init();
-    sen66_init(SEN66_I2C_ADDR_6B);
-    sensirion_i2c_hal_sleep_usec(20000); // Wait 20ms after powering up
+    sen66_sensor_init(&default_ctx, 0, SEN66_I2C_ADDR_6B, sensorAltitudeM);
+}
 
-    int16_t ret = sen66_set_sensor_altitude(sensorAltitudeM);
-    if (ret) {
-        ESP_LOGE(TAG, "sen66_set_sensor_altitude(%u m) failed: %d", sensorAltitudeM, ret);
-    } else {
-        ESP_LOGI(TAG, "Sensor altitude set to %u m", sensorAltitudeM);
+void sen66_start_measurement() {
+    sen66_start_measurement(&default_ctx);
+}
+
+int16_t sen66_read_data(sen66_data_t *data) {
+    return sen66_read_data(&default_ctx, data);
+}
+
+bool sen66_get_measurement(sen66_data_t *out_data) {
+    return sen66_get_measurement(&default_ctx, out_data);
+}
+
+bool sen66_get_measurement(Sen66PhaseLock &phaseLock, sen66_data_t *out_data) {
+    return sen66_get_measurement(&default_ctx, phaseLock, out_data);
+}
+
+bool sen66_get_measurement(Sen66PhaseLock &phaseLock, uint8_t frames, sen66_record_t *out_record) {
+    return sen66_get_measurement(&default_ctx, phaseLock, frames, out_record);
+}
+
+// The sensor is powered together with the ESP32, so the time since boot
+// already counts towards its start-up; usually nothing is left to wait.
+static void wait_power_up() {
+    int64_t now = esp_timer_get_time();
+    if (now < POWER_UP_US)
+        sensirion_i2c_hal_sleep_usec(static_cast<uint32_t>(POWER_UP_US - now));
+}
+
+void sen66_sensor_init(sen66_ctx_t *ctx, uint8_t busIdx, uint8_t i2cAddress, uint16_t sensorAltitudeM) {
+    sen66_init(ctx, busIdx, i2cAddress);
+    wait_power_up();
+
+    sen66_config_t config = sen66_default_config();
+    config.altitude_m = sensorAltitudeM;
+    bool measuring;
+    sen66_apply_config(ctx, &config, &measuring);
+}
+
+bool sen66_bring_up(sen66_ctx_t *ctx, uint8_t busIdx, uint8_t i2cAddress, const sen66_config_t *config) {
+    sen66_init(ctx, busIdx, i2cAddress);
+    wait_power_up();
+    return sen66_configure_and_start(ctx, config);
+}
+
+bool sen66_configure_and_start(sen66_ctx_t *ctx, const sen66_config_t *config) {
+    bool measuring;
+    if (sen66_apply_config(ctx, config, &measuring) != NO_ERROR)
+        return false;
+    if (measuring)
+        return true; // kept running, VOC state included
+
+    sen66_voc_state_restore(ctx);
+    int16_t ret = sen66_start_continuous_measurement(ctx);
+    if (ret != NO_ERROR) {
+        ESP_LOGE(TAG, "Failed to start continuous measurement, error: %d", ret);
+        return false;
     }
+    return true;
 }
 
-void sen66_start_measurement() {
-    int16_t ret = sen66_start_continuous_measurement();
+bool sen66_bring_up(const sen66_config_t *config) {
+    const int64_t start = esp_timer_get_time();
+    sensirion_i2c_hal_init();
+    bool ok = sen66_bring_up(&default_ctx, 0, SEN66_I2C_ADDR_6B, config);
+    ESP_LOGI(TAG, "Sensor bring-up %s in %lld ms, %lld ms after boot", ok ? "done" : "failed",
+             (long long)(esp_timer_get_time() - start) / 1000, (long long)esp_timer_get_time() / 1000);
+    return ok;
+}
+
+void sen66_start_measurement(sen66_ctx_t *ctx) {
+    int16_t ret = sen66_start_continuous_measurement(ctx);
     if (ret != 0) {
         ESP_LOGE(TAG, "Failed to start continuous measurement, error: %d", ret);
     } else {
@@ -35,50 +116,210 @@ void sen66_start_measurement() {
     }
 }
 
-bool sen66_read_data(sen66_data_t *data) {
+void sen66_record_blank_pm(sen66_record_t *record) {
+    record->pm1_0 = record->pm2_5 = record->pm4_0 = record->pm10_0 = INVALID_UINT16;
+    record->nc0_5 = record->nc1_0 = record->nc2_5 = record->nc4_0 = record->nc10_0 = INVALID_UINT16;
+}
+
+void sen66_record_to_data(const sen66_record_t *record, sen66_data_t *data) {
+    data->raw_pm1_0       = record->pm1_0;
+    data->raw_pm2_5       = record->pm2_5;
+    data->raw_pm10_0      = record->pm10_0;
+    data->raw_humidity    = record->humidity;
+    data->raw_temperature = record->temperature;
+    data->raw_voc_index   = record->voc_index;
+    data->raw_nox_index   = record->nox_index;
+    data->raw_co2         = record->co2;
+    data->raw_hcho        = record->hcho;
+
+    // Scaling and invalid markers come from the wire format in sen6x_traits.h.
+    data->pm1_0          = sen6x::decode(sen6x::PM1_0, record->pm1_0);
+    data->pm2_5          = sen6x::decode(sen6x::PM2_5, record->pm2_5);
+    data->pm10_0         = sen6x::decode(sen6x::PM10_0, record->pm10_0);
+    data->humidity       = sen6x::decode(sen6x::HUMIDITY, uint16_t(record->humidity));
+    data->temperature    = sen6x::decode(sen6x::TEMPERATURE, uint16_t(record->temperature));
+    data->voc_index      = sen6x::decode(sen6x::VOC_INDEX, uint16_t(record->voc_index));
+    data->nox_index      = sen6x::decode(sen6x::NOX_INDEX, uint16_t(record->nox_index));
+    data->co2_equivalent = sen6x::decode(sen6x::CO2, record->co2);
+    data->hcho           = sen6x::decode(sen6x::HCHO, record->hcho);
+}
+
+// Stores one word of the measured-values frame. Called with constant
+// channels from the unrolled layout loop below, so the switch folds away.
+static inline void store_value(sen6x::Channel channel, uint16_t word, sen66_record_t *record) {
+    switch (channel) {
+    case sen6x::PM1_0:       record->pm1_0 = word; break;
+    case sen6x::PM2_5:       record->pm2_5 = word; break;
+    case sen6x::PM4_0:       record->pm4_0 = word; break;
+    case sen6x::PM10_0:      record->pm10_0 = word; break;
+    case sen6x::HUMIDITY:    record->humidity = int16_t(word); break;
+    case sen6x::TEMPERATURE: record->temperature = int16_t(word); break;
+    case sen6x::VOC_INDEX:   record->voc_index = int16_t(word); break;
+    case sen6x::NOX_INDEX:   record->nox_index = int16_t(word); break;
+    case sen6x::CO2:         record->co2 = word; break;
+    case sen6x::HCHO:        record->hcho = word; break;
+    }
+}
+
+// The measured-values read of the configured module; also clears data-ready.
+static int16_t read_values(sen66_ctx_t *ctx, uint16_t *words) {
+    return sen66::read_words(ctx, sen6x::Active::kReadValues, words);
+}
+
+// Reads the selected frames back to back. Goes through locals because the
+// record is packed and its fields cannot be passed by pointer.
+static int16_t read_frames(sen66_ctx_t *ctx, uint8_t frames, sen66_record_t *record) {
+    uint16_t words[sen6x::Active::words()];
+    uint16_t u[5];
+    int16_t  i[2];
+
+    *record = INVALID_RECORD;
+    int16_t ret = read_values(ctx, words);
+    if (ret != NO_ERROR) {
+        ESP_LOGW(TAG, "Reading the %s measured values failed with error code %d", sen6x::Active::kName, ret);
+        return ret;
+    }
+    for (size_t w = 0; w < sen6x::Active::words(); w++)
+        store_value(sen6x::Active::kLayout[w], words[w], record);
+    record->frames = SEN66_FRAME_VALUES;
+
+    if (frames & SEN66_FRAME_NUMBER_CONCENTRATIONS) {
+        ret = sen66_read_number_concentration_values_as_integers(ctx, &u[0], &u[1], &u[2], &u[3], &u[4]);
+        if (ret != NO_ERROR) {
+            ESP_LOGW(TAG, "sen66_read_number_concentration_values_as_integers failed with error code %d", ret);
+            return ret;
+        }
+        record->nc0_5 = u[0];
+        record->nc1_0 = u[1];
+        record->nc2_5 = u[2];
+        record->nc4_0 = u[3];
+        record->nc10_0 = u[4];
+        record->frames |= SEN66_FRAME_NUMBER_CONCENTRATIONS;
+    }
+
+    if (sen6x::Active::kRawValues && (frames & SEN66_FRAME_RAW)) {
+        ret = sen66_read_measured_raw_values(ctx, &i[0], &i[1], &u[0], &u[1], &u[2]);
+        if (ret != NO_ERROR) {
+            ESP_LOGW(TAG, "sen66_read_measured_raw_values failed with error code %d", ret);
+            return ret;
+        }
+        record->raw_humidity = i[0];
+        record->raw_temperature = i[1];
+        record->raw_voc = u[0];
+        record->raw_nox = u[1];
+        record->raw_co2 = u[2];
+        record->frames |= SEN66_FRAME_RAW;
+    }
+    return NO_ERROR;
+}
 
+int16_t sen66_read_record(sen66_ctx_t *ctx, uint8_t frames, sen66_record_t *record) {
     uint8_t padding;
     bool ready;
-    int ret = sen66_get_data_ready(&padding, &ready);
+    int16_t ret = sen66_get_data_ready(ctx, &padding, &ready);
     if (ret != 0) {
         ESP_LOGW(TAG, "sen66_get_data_ready failed with error code %d", ret);
-        return false;
+        return ret;
     }
     if (!ready) {
-        ESP_LOGW(TAG, "Sensor data not ready");
-        return false;
+        ESP_LOGD(TAG, "Sensor data not ready");
+        return SEN66_DATA_NOT_READY_ERROR;
     }
 
-    uint16_t raw_pm1, raw_pm25, raw_pm4, raw_pm10, raw_co2;
-    int16_t  raw_hum, raw_temp, raw_voc, raw_nox;
-
-    sen66_read_measured_values_as_integers(
-        &raw_pm1, &raw_pm25, &raw_pm4, &raw_pm10,
-        &raw_hum, &raw_temp, &raw_voc, &raw_nox, &raw_co2);
-
-        data->pm1_0        = (raw_pm1  != INVALID_UINT16) ? raw_pm1  / 10.0f : NAN;
-        data->pm2_5        = (raw_pm25 != INVALID_UINT16) ? raw_pm25 / 10.0f : NAN;
-        data->pm10_0       = (raw_pm10 != INVALID_UINT16) ? raw_pm10 / 10.0f : NAN;
-        data->humidity     = (raw_hum  != INVALID_INT16) ? raw_hum  / 100.0f : NAN;
-        data->temperature  = (raw_temp != INVALID_INT16) ? raw_temp / 200.0f : NAN;
-        data->voc_index    = (raw_voc  != INVALID_INT16) ? raw_voc  / 10.0f : NAN;
-        data->nox_index    = (raw_nox  != INVALID_INT16) ? raw_nox  / 10.0f : NAN;
-        data->co2_equivalent = (raw_co2 != INVALID_UINT16) ? float(raw_co2) : NAN;
+    const int64_t readyUs = esp_timer_get_time();
+    ret = read_frames(ctx, frames, record);
+    record->timestamp_us = readyUs;
+    return ret;
+}
 
-    return true;
+int16_t sen66_read_data(sen66_ctx_t *ctx, sen66_data_t *data) {
+    sen66_record_t record;
+    int16_t ret = sen66_read_record(ctx, SEN66_FRAME_VALUES, &record);
+    if (ret == NO_ERROR)
+        sen66_record_to_data(&record, data);
+    return ret;
 }
 
-bool sen66_get_measurement(sen66_data_t *out_data) {
+bool sen66_get_measurement(sen66_ctx_t *ctx, sen66_data_t *out_data) {
     TickType_t elapsed = 0;
     while (elapsed < MAX_WAIT) {
-        if (sen66_read_data(out_data)) {
+        int16_t ret = sen66_read_data(ctx, out_data);
+        if (ret == NO_ERROR) {
             // ready flag was set and values decoded
             return true;
         }
+        if (ret != SEN66_DATA_NOT_READY_ERROR) {
+            // The HAL has already retried and recovered the bus; give up on
+            // this cycle and try again on the next one.
+            sensirion_i2c_hal_stats_t stats;
+            sensirion_i2c_hal_get_stats(&stats);
+            ESP_LOGW(TAG, "sen66_get_measurement: I2C error %d (nack %lu, timeout %lu, bus %lu, resets %lu)",
+                     ret, (unsigned long)stats.nack_errors, (unsigned long)stats.timeout_errors,
+                     (unsigned long)stats.bus_errors, (unsigned long)stats.bus_resets);
+            return false;
+        }
         vTaskDelay(POLL_PERIOD);
         elapsed += POLL_PERIOD;
     }
 
     ESP_LOGW(TAG, "sen66_get_measurement: timeout waiting for data-ready");
     return false;
-}
\ No newline at end of file
+}
+
+bool sen66_get_measurement(sen66_ctx_t *ctx, Sen66PhaseLock &phaseLock, sen66_data_t *out_data) {
+    sen66_record_t record;
+    if (!sen66_get_measurement(ctx, phaseLock, SEN66_FRAME_VALUES, &record))
+        return false;
+    sen66_record_to_data(&record, out_data);
+    return true;
+}
+
+bool sen66_get_measurement(sen66_ctx_t *ctx, Sen66PhaseLock &phaseLock, uint8_t frames, sen66_record_t *out_record) {
+    // Reading the values clears data-ready, so the next time the flag is set
+    // marks a fresh update. What this read returns is discarded.
+    uint16_t words[sen6x::Active::words()];
+    const int64_t start = esp_timer_get_time();
+    int16_t ret = read_values(ctx, words);
+    if (ret != 0) {
+        ESP_LOGW(TAG, "sen66_get_measurement: I2C error %d", ret);
+        return false;
+    }
+    phaseLock.onCleared(start);
+
+    if (phaseLock.locked()) {
+        int64_t checkAt = phaseLock.nextUpdateUs(start) + Sen66PhaseLock::kGuardUs;
+        int64_t now = esp_timer_get_time();
+        if (checkAt > now)
+            sensirion_i2c_hal_sleep_usec(static_cast<uint32_t>(checkAt - now));
+    }
+
+    while (true) {
+        // Timestamp the data-ready check itself; the values read that
+        // follows would widen the edge bracket by several milliseconds.
+        uint8_t padding;
+        bool ready;
+        int64_t before = esp_timer_get_time();
+        ret = sen66_get_data_ready(ctx, &padding, &ready);
+        if (ret == NO_ERROR && ready) {
+            const int64_t readyUs = esp_timer_get_time();
+            phaseLock.onDataReady(true, readyUs);
+            ret = read_frames(ctx, frames, out_record);
+            out_record->timestamp_us = readyUs;
+            if (ret == NO_ERROR)
+                return true;
+        }
+        if (ret != NO_ERROR) {
+            ESP_LOGW(TAG, "sen66_get_measurement: I2C error %d", ret);
+            return false;
+        }
+
+        phaseLock.onDataReady(false, before);
+        if (before - start > RELOCK_TIMEOUT_US) {
+            ESP_LOGW(TAG, "sen66_get_measurement: no data-ready edge within %lld ms",
+                     (long long)(RELOCK_TIMEOUT_US / 1000));
+            return false;
+        }
+        // Through the HAL so the wait shows up as sleep in the bus profile.
+        sensirion_i2c_hal_sleep_usec(RELOCK_POLL_PERIOD_US);
+    }
+}
@@ -0,0 +1,133 @@
+#include "sen66_supervisor.h"
+#include "sen66_sensor.h"
+#include "sen66_voc_state.h"
+#include "sensirion_common.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+static const char *TAG = "SEN66_SUPERVISOR";
+
+static bool has_error(const sen66_device_status &status) {
+    return status.fan_error || status.rht_error || status.gas_error || status.co2_2_error ||
+           status.pm_error;
+}
+
+Sen66Supervisor::Sen66Supervisor(sen66_ctx_t *ctx, const sen66_config_t &config, uint32_t checkEvery)
+    : mCtx(ctx), mConfig(config), mCheckEvery(checkEvery ? checkEvery : 1)
+{
+}
+
+void Sen66Supervisor::onCycle(bool acquired)
+{
+    const uint32_t cycle = mCycle++;
+    mFailedReads = acquired ? 0 : mFailedReads + 1;
+    const bool readsFailing = mFailedReads >= kFailedReadLimit;
+
+    const bool settled = mStage == Stage::Healthy || mStage == Stage::Failed;
+    if (settled && !readsFailing && cycle % mCheckEvery != 0)
+        return;
+
+    sen66_device_status status;
+    const int16_t ret = sen66_read_device_status(mCtx, &status);
+    mStats.checks++;
+    bool statusError = ret != NO_ERROR;
+    if (ret == NO_ERROR) {
+        mStats.lastStatus = status.value;
+        statusError = has_error(status);
+        if (status.fan_speed_warning)
+            mStats.warnings++;
+    }
+
+    const int64_t now = esp_timer_get_time();
+    if (!statusError && !readsFailing) {
+        if (mStage != Stage::Healthy && acquired)
+            recovered(now);
+        return;
+    }
+
+    if (mStage == Stage::Healthy) {
+        mStats.faults++;
+        mFaultStartUs = now;
+        if (ret != NO_ERROR)
+            ESP_LOGW(TAG, "Device status unreadable (%d); recovering", ret);
+        else if (statusError)
+            ESP_LOGW(TAG, "Device status 0x%08lx (fan %u, RHT %u, gas %u, CO2 %u, PM %u); recovering",
+                     (unsigned long)status.value, status.fan_error, status.rht_error, status.gas_error,
+                     status.co2_2_error, status.pm_error);
+        else
+            ESP_LOGW(TAG, "%lu acquisitions failed in a row; recovering", (unsigned long)mFailedReads);
+    } else if (mStage == Stage::Failed && cycle < mRetryAtCycle) {
+        return;
+    }
+    escalate(statusError && ret == NO_ERROR && !readsFailing);
+}
+
+void Sen66Supervisor::escalate(bool statusError)
+{
+    switch (mStage) {
+    case Stage::Healthy:
+        if (statusError) {
+            clear();
+            break;
+        }
+        restart();
+        break;
+    case Stage::Cleared:
+    case Stage::Failed:
+        restart();
+        break;
+    case Stage::Restarted:
+        reset();
+        break;
+    case Stage::Reset:
+        mStats.unrecovered++;
+        mStage = Stage::Failed;
+        mRetryAtCycle = mCycle + kRetryCycles;
+        ESP_LOGE(TAG, "Sensor still faulty after a device reset; retrying in %lu cycles",
+                 (unsigned long)kRetryCycles);
+        break;
+    }
+}
+
+void Sen66Supervisor::clear()
+{
+    sen66_device_status status;
+    int16_t ret = sen66_read_and_clear_device_status(mCtx, &status);
+    mStats.clears++;
+    mStage = Stage::Cleared;
+    ESP_LOGI(TAG, "Cleared device status: %d", ret);
+}
+
+void Sen66Supervisor::restart()
+{
+    // Stopping fails if the sensor is idle already, e.g. after losing power.
+    sen66_stop_measurement(mCtx);
+    int16_t ret = sen66_start_continuous_measurement(mCtx);
+    mStats.restarts++;
+    mStage = Stage::Restarted;
+    ESP_LOGI(TAG, "Restarted the measurement: %d", ret);
+}
+
+void Sen66Supervisor::reset()
+{
+    // Keep the VOC learning; the reset wipes it along with the settings.
+    sen66_voc_state_snapshot(mCtx);
+    int16_t ret = sen66_device_reset(mCtx);
+    bool started = ret == NO_ERROR && sen66_configure_and_start(mCtx, &mConfig);
+    mStats.resets++;
+    mStage = Stage::Reset;
+    ESP_LOGW(TAG, "Device reset: %d, %s", ret, started ? "measuring again" : "not measuring");
+}
+
+void Sen66Supervisor::recovered(int64_t nowUs)
+{
+    const int64_t took = nowUs - mFaultStartUs;
+    mStats.lastRecoveryUs = took;
+    if (took > mStats.maxRecoveryUs)
+        mStats.maxRecoveryUs = took;
+    mStage = Stage::Healthy;
+    ESP_LOGI(TAG, "Sensor recovered after %lld ms (faults %lu: clears %lu, restarts %lu, resets %lu, unrecovered %lu)",
+             (long long)(took / 1000), (unsigned long)mStats.faults, (unsigned long)mStats.clears,
+             (unsigned long)mStats.restarts, (unsigned long)mStats.resets, (unsigned long)mStats.unrecovered);
+}
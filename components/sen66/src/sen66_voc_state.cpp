@@ -0,0 +1,147 @@
+#include "sen66_voc_state.h"
+#include "sen6x_traits.h"
+#include "sensirion_common.h"
+#include "sdkconfig.h"
+
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_rom_crc.h>
+#include <esp_timer.h>
+#include <nvs.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+static const char *TAG = "SEN66_VOC_STATE";
+static const char *NVS_NAMESPACE = "sen66";
+static constexpr uint32_t RECORD_MAGIC = 0x53434F56; // "VOCS"
+static constexpr size_t RTC_SLOTS = 4;               // sensors tracked across warm resets
+static constexpr int64_t NVS_INTERVAL_US = int64_t(CONFIG_SEN66_VOC_STATE_NVS_INTERVAL_MIN) * 60 * 1000 * 1000;
+
+struct VocStateRecord {
+    uint32_t magic;
+    uint8_t  bus_idx;
+    uint8_t  address;
+    uint8_t  state[SEN66_VOC_STATE_SIZE];
+    uint16_t reserved;
+    uint32_t crc; // over all fields above
+};
+
+// Not touched by the startup code, so it holds the last snapshots after a
+// software reset and random bytes after a power cycle.
+static RTC_NOINIT_ATTR VocStateRecord rtc_records[RTC_SLOTS];
+
+// Last NVS write per RTC slot, on this boot.
+static int64_t persisted_at_us[RTC_SLOTS];
+
+static uint32_t record_crc(const VocStateRecord &record) {
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t *>(&record),
+                            offsetof(VocStateRecord, crc));
+}
+
+static bool record_valid(const VocStateRecord &record, const sen66_ctx_t *ctx) {
+    return record.magic == RECORD_MAGIC && record.bus_idx == ctx->bus_idx &&
+           record.address == ctx->i2c_address && record.crc == record_crc(record);
+}
+
+// The slot holding ctx's record, else a free or corrupt one, else slot 0.
+static VocStateRecord &rtc_slot(const sen66_ctx_t *ctx, size_t *index) {
+    size_t free_slot = RTC_SLOTS;
+    for (size_t i = 0; i < RTC_SLOTS; i++) {
+        const VocStateRecord &record = rtc_records[i];
+        if (record.magic == RECORD_MAGIC && record.crc == record_crc(record)) {
+            if (record.bus_idx == ctx->bus_idx && record.address == ctx->i2c_address) {
+                *index = i;
+                return rtc_records[i];
+            }
+        } else if (free_slot == RTC_SLOTS) {
+            free_slot = i;
+        }
+    }
+    *index = free_slot < RTC_SLOTS ? free_slot : 0;
+    return rtc_records[*index];
+}
+
+static void nvs_key(const sen66_ctx_t *ctx, char *key, size_t size) {
+    snprintf(key, size, "voc%u_%02x", ctx->bus_idx, ctx->i2c_address);
+}
+
+static bool load_nvs(const sen66_ctx_t *ctx, VocStateRecord *out) {
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK)
+        return false;
+
+    char key[16];
+    nvs_key(ctx, key, sizeof(key));
+    size_t size = sizeof(*out);
+    esp_err_t err = nvs_get_blob(handle, key, out, &size);
+    nvs_close(handle);
+    return err == ESP_OK && size == sizeof(*out) && record_valid(*out, ctx);
+}
+
+static void store_nvs(const sen66_ctx_t *ctx, const VocStateRecord &record) {
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to open NVS namespace");
+        return;
+    }
+
+    char key[16];
+    nvs_key(ctx, key, sizeof(key));
+    esp_err_t err = nvs_set_blob(handle, key, &record, sizeof(record));
+    if (err == ESP_OK)
+        err = nvs_commit(handle);
+    if (err != ESP_OK)
+        ESP_LOGW(TAG, "Failed to write VOC state to NVS (%d)", err);
+    nvs_close(handle);
+}
+
+bool sen66_voc_state_restore(sen66_ctx_t *ctx) {
+    if constexpr (!sen6x::Active::has(sen6x::VOC_INDEX))
+        return false;
+    size_t index;
+    VocStateRecord record = rtc_slot(ctx, &index);
+    const char *source = "RTC memory";
+    if (!record_valid(record, ctx)) {
+        source = "NVS";
+        if (!load_nvs(ctx, &record)) {
+            ESP_LOGI(TAG, "No saved VOC algorithm state; the VOC index starts learning");
+            return false;
+        }
+    }
+
+    int16_t ret = sen66_set_voc_algorithm_state(ctx, record.state, sizeof(record.state));
+    if (ret != NO_ERROR) {
+        ESP_LOGW(TAG, "sen66_set_voc_algorithm_state failed: %d (sensor still measuring?)", ret);
+        return false;
+    }
+    ESP_LOGI(TAG, "VOC algorithm state restored from %s", source);
+    return true;
+}
+
+int16_t sen66_voc_state_snapshot(sen66_ctx_t *ctx) {
+    if constexpr (!sen6x::Active::has(sen6x::VOC_INDEX))
+        return NO_ERROR; // nothing to keep
+    VocStateRecord record = {};
+    int16_t ret = sen66_get_voc_algorithm_state(ctx, record.state, sizeof(record.state));
+    if (ret != NO_ERROR) {
+        ESP_LOGW(TAG, "sen66_get_voc_algorithm_state failed: %d", ret);
+        return ret;
+    }
+    record.magic = RECORD_MAGIC;
+    record.bus_idx = ctx->bus_idx;
+    record.address = ctx->i2c_address;
+    record.crc = record_crc(record);
+
+    size_t index;
+    rtc_slot(ctx, &index) = record;
+
+    const int64_t now = esp_timer_get_time();
+    if (persisted_at_us[index] == 0)
+        persisted_at_us[index] = now; // first NVS write one interval after boot
+    if (now - persisted_at_us[index] >= NVS_INTERVAL_US) {
+        store_nvs(ctx, record);
+        persisted_at_us[index] = now;
+    }
+    return NO_ERROR;
+}
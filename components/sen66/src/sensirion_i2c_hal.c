@@ -1,75 +1,617 @@
 #include "sensirion_i2c_hal.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c.h"
+#include "sensirion_i2c_trace.h"
 #include "driver/i2c_master.h"
 #include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <string.h>
 
 static const char *TAG = "sensirion_i2c_hal";
 
-#define I2C_MASTER_SDA_IO 11 
-#define I2C_MASTER_SCL_IO 12
-#define I2C_MASTER_NUM      I2C_NUM_0
-#define I2C_MASTER_FREQ_HZ  100000
+static void sensirion_i2c_hal_sleep(uint32_t useconds);
+
+#define I2C_MASTER_MAX_DEVICES 8
+// Depth > 0 puts the bus in asynchronous mode; transfers wait on the
+// completion callback instead of inside the driver.
+#define I2C_MASTER_TRANS_QUEUE_DEPTH 4
+// First retry waits 1 ms, every further one twice as long.
+#define I2C_MASTER_BACKOFF_BASE_US 1000
+
+#define HAL_INSTRUMENTED (CONFIG_SEN66_I2C_TRACE || CONFIG_SEN66_I2C_PROFILE)
+
+struct sensirion_i2c_hal_device {
+    i2c_master_dev_handle_t handle;
+    uint8_t bus_idx;
+    uint8_t address;
+    SemaphoreHandle_t done;              // given by the ISR on completion
+    volatile int8_t status;              // result of the last transaction
+    volatile bool polling;               // NACKs are expected, don't count them
+    sensirion_i2c_hal_device_stats_t bus_stats; // under bus_lock_mux
+#if HAL_INSTRUMENTED
+    uint16_t last_opcode;                // profile key of the following reads
+#endif
+};
+
+typedef struct {
+    i2c_master_bus_handle_t handle;
+    uint32_t frequency_hz;
+    // Held for one transaction. A semaphore rather than a mutex, so recovery
+    // can take it over from a stuck holder; owner tells which device holds
+    // it, so the overridden holder cannot release the new one's.
+    SemaphoreHandle_t lock;
+    sensirion_i2c_hal_device_t* volatile owner;
+    int64_t granted_us;
+    sensirion_i2c_hal_bus_stats_t stats; // under bus_lock_mux
+} hal_bus_t;
+
+// Each bus maps to the I2C controller with the same index (I2C_NUM_0/1), so
+// transfers on different buses run in parallel.
+static hal_bus_t buses[SENSIRION_I2C_HAL_MAX_BUSES];
+static uint8_t selected_bus = 0;
+static sensirion_i2c_hal_device_t devices[I2C_MASTER_MAX_DEVICES];
+static uint8_t device_count = 0;
+static SemaphoreHandle_t devices_lock = NULL;
+static sensirion_i2c_hal_stats_t stats;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static portMUX_TYPE bus_lock_mux = portMUX_INITIALIZER_UNLOCKED;
+
+#define HAL_STAT_INC(field)                  \
+    do {                                     \
+        portENTER_CRITICAL_SAFE(&stats_lock); \
+        stats.field++;                       \
+        portEXIT_CRITICAL_SAFE(&stats_lock);  \
+    } while (0)
+
+#if CONFIG_SEN66_I2C_PROFILE
+static sensirion_i2c_hal_profile_t profile;
+static uint64_t profile_bus_us; // all transactions, untracked ones included
+static portMUX_TYPE profile_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint8_t sensirion_i2c_hal_profile_bucket(uint32_t us)
+{
+    if (us < 2)
+        return 0;
+    uint8_t bucket = (uint8_t)(31 - __builtin_clz(us));
+    return bucket < SENSIRION_I2C_HAL_PROFILE_BUCKETS ? bucket
+                                                      : SENSIRION_I2C_HAL_PROFILE_BUCKETS - 1;
+}
 
-static i2c_master_bus_handle_t bus_handle = NULL;
-static i2c_master_dev_handle_t dev_handle = NULL;
+static void sensirion_i2c_hal_profile_transaction(uint16_t opcode, bool read,
+                                                  uint8_t count, int8_t status,
+                                                  uint32_t duration_us)
+{
+    sensirion_i2c_hal_opcode_profile_t *entry = NULL;
+
+    portENTER_CRITICAL_SAFE(&profile_lock);
+    profile_bus_us += duration_us;
+    for (uint8_t i = 0; i < profile.opcode_count; i++) {
+        if (profile.opcodes[i].opcode == opcode) {
+            entry = &profile.opcodes[i];
+            break;
+        }
+    }
+    if (entry == NULL && profile.opcode_count < SENSIRION_I2C_HAL_PROFILE_OPCODES) {
+        entry = &profile.opcodes[profile.opcode_count++];
+        entry->opcode = opcode;
+    }
+    if (entry != NULL) {
+        entry->transactions++;
+        if (status != NO_ERROR)
+            entry->errors++;
+        if (!read)
+            entry->tx_bytes += count;
+        else if (status == NO_ERROR)
+            entry->rx_bytes += count;
+        entry->bus_us += duration_us;
+        entry->latency[sensirion_i2c_hal_profile_bucket(duration_us)]++;
+    } else {
+        profile.untracked++;
+    }
+    portEXIT_CRITICAL_SAFE(&profile_lock);
+}
+#endif
+
+#if HAL_INSTRUMENTED
+#define HAL_NOW() ((uint32_t)esp_timer_get_time())
+#define HAL_INSTRUMENT(dev, dir, data, count, status, start_us) \
+    sensirion_i2c_hal_instrument((dev), (dir), (data), (count), (status), (start_us))
+
+/* Hand one finished transaction to the recorder and the profile. */
+static void sensirion_i2c_hal_instrument(sensirion_i2c_hal_device_t *dev,
+                                         sensirion_i2c_trace_dir_t dir,
+                                         const uint8_t *data, uint8_t count,
+                                         int8_t status, uint32_t start_us)
+{
+    const uint32_t duration_us = HAL_NOW() - start_us;
+
+#if CONFIG_SEN66_I2C_TRACE
+    sensirion_i2c_trace_record(dev->bus_idx, dev->address, dir, data, count,
+                               status, start_us, duration_us);
+#endif
+#if CONFIG_SEN66_I2C_PROFILE
+    if (dir == SENSIRION_I2C_TRACE_WRITE && count >= 2)
+        dev->last_opcode = (uint16_t)(data[0] << 8 | data[1]);
+    sensirion_i2c_hal_profile_transaction(dev->last_opcode,
+                                          dir != SENSIRION_I2C_TRACE_WRITE,
+                                          count, status, duration_us);
+#endif
+}
+#else
+#define HAL_NOW() 0u
+#define HAL_INSTRUMENT(dev, dir, data, count, status, start_us) ((void)(start_us))
+#endif
+
+/* Record a grant of dev's bus, requested at request_us. */
+static void sensirion_i2c_hal_bus_granted(sensirion_i2c_hal_device_t *dev,
+                                          int64_t request_us, bool contended)
+{
+    hal_bus_t *bus = &buses[dev->bus_idx];
+    const int64_t now = esp_timer_get_time();
+    const uint32_t waited_us = (uint32_t)(now - request_us);
+
+    portENTER_CRITICAL(&bus_lock_mux);
+    bus->owner = dev;
+    bus->granted_us = now;
+    bus->stats.transactions++;
+    if (contended)
+        bus->stats.contended++;
+    bus->stats.wait_us += waited_us;
+    if (waited_us > bus->stats.max_wait_us)
+        bus->stats.max_wait_us = waited_us;
+    dev->bus_stats.transactions++;
+    dev->bus_stats.wait_us += waited_us;
+    if (waited_us > dev->bus_stats.max_wait_us)
+        dev->bus_stats.max_wait_us = waited_us;
+    portEXIT_CRITICAL(&bus_lock_mux);
+}
+
+/*
+ * Take dev's bus for one transaction, waiting at most
+ * CONFIG_SEN66_I2C_BUS_WAIT_MS. Task context only.
+ */
+static bool sensirion_i2c_hal_bus_acquire(sensirion_i2c_hal_device_t *dev)
+{
+    hal_bus_t *bus = &buses[dev->bus_idx];
+    const int64_t request_us = esp_timer_get_time();
+    bool contended = false;
+
+    if (xSemaphoreTake(bus->lock, 0) != pdTRUE) {
+        contended = true;
+        if (xSemaphoreTake(bus->lock, pdMS_TO_TICKS(CONFIG_SEN66_I2C_BUS_WAIT_MS)) != pdTRUE) {
+            portENTER_CRITICAL(&bus_lock_mux);
+            bus->stats.wait_timeouts++;
+            portEXIT_CRITICAL(&bus_lock_mux);
+            return false;
+        }
+    }
+    sensirion_i2c_hal_bus_granted(dev, request_us, contended);
+    return true;
+}
+
+/* Hand back dev's bus if dev still holds it. */
+static void sensirion_i2c_hal_bus_release(sensirion_i2c_hal_device_t *dev)
+{
+    hal_bus_t *bus = &buses[dev->bus_idx];
+    const int64_t now = esp_timer_get_time();
+    bool held;
+
+    portENTER_CRITICAL(&bus_lock_mux);
+    held = bus->owner == dev;
+    if (held) {
+        const uint32_t hold_us = (uint32_t)(now - bus->granted_us);
+        bus->owner = NULL;
+        bus->stats.busy_us += hold_us;
+        if (hold_us > bus->stats.max_hold_us)
+            bus->stats.max_hold_us = hold_us;
+    }
+    portEXIT_CRITICAL(&bus_lock_mux);
+
+    if (held)
+        xSemaphoreGive(bus->lock);
+}
+
+static int8_t sensirion_i2c_hal_event_to_status(const sensirion_i2c_hal_device_t *dev,
+                                                i2c_master_event_t event)
+{
+    switch (event) {
+    case I2C_EVENT_DONE:
+        return NO_ERROR;
+    case I2C_EVENT_NACK:
+        if (dev->polling)
+            HAL_STAT_INC(poll_nacks);
+        else
+            HAL_STAT_INC(nack_errors);
+        return I2C_NACK_ERROR;
+    case I2C_EVENT_TIMEOUT:
+        HAL_STAT_INC(timeout_errors);
+        return I2C_BUS_ERROR;
+    default:
+        HAL_STAT_INC(bus_errors);
+        return I2C_BUS_ERROR;
+    }
+}
+
+static bool sensirion_i2c_hal_on_trans_done(i2c_master_dev_handle_t handle,
+                                            const i2c_master_event_data_t *edata,
+                                            void *user_ctx)
+{
+    sensirion_i2c_hal_device_t *dev = (sensirion_i2c_hal_device_t *)user_ctx;
+    BaseType_t woken = pdFALSE;
+    (void)handle;
+
+    if (edata->event == I2C_EVENT_ALIVE)
+        return false;
+
+    dev->status = sensirion_i2c_hal_event_to_status(dev, edata->event);
+    xSemaphoreGiveFromISR(dev->done, &woken);
+    return woken == pdTRUE;
+}
 
-i2c_master_dev_handle_t sensirion_i2c_hal_add_device(uint8_t address)
+static esp_err_t sensirion_i2c_hal_add_device(sensirion_i2c_hal_device_t *dev,
+                                              uint8_t bus_idx, uint8_t address)
 {
     i2c_device_config_t dev_cfg = {
         .dev_addr_length = I2C_ADDR_BIT_LEN_7,
         .device_address = address,
-        .scl_speed_hz = 100000,
+        .scl_speed_hz = buses[bus_idx].frequency_hz,
     };
 
-    i2c_master_dev_handle_t dev_handle;
-    ESP_ERROR_CHECK(i2c_master_bus_add_device(bus_handle, &dev_cfg, &dev_handle));
+    esp_err_t err = i2c_master_bus_add_device(buses[bus_idx].handle, &dev_cfg, &dev->handle);
+    if (err != ESP_OK)
+        return err;
 
-    return dev_handle;
+    dev->bus_idx = bus_idx;
+    dev->address = address;
+    if (dev->done == NULL)
+        dev->done = xSemaphoreCreateBinary();
+    i2c_master_event_callbacks_t cbs = {
+        .on_trans_done = sensirion_i2c_hal_on_trans_done,
+    };
+    return i2c_master_register_event_callbacks(dev->handle, &cbs, dev);
+}
+
+sensirion_i2c_hal_device_t* sensirion_i2c_hal_get_device(uint8_t bus_idx,
+                                                         uint8_t address)
+{
+    sensirion_i2c_hal_device_t *dev = NULL;
+
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES || buses[bus_idx].handle == NULL) {
+        ESP_LOGE(TAG, "I2C bus %u is not initialized", bus_idx);
+        return NULL;
+    }
+
+    xSemaphoreTake(devices_lock, portMAX_DELAY);
+    for (uint8_t i = 0; i < device_count; i++) {
+        if (devices[i].bus_idx == bus_idx && devices[i].address == address) {
+            dev = &devices[i];
+            break;
+        }
+    }
+    if (dev == NULL && device_count < I2C_MASTER_MAX_DEVICES) {
+        if (sensirion_i2c_hal_add_device(&devices[device_count], bus_idx, address) == ESP_OK)
+            dev = &devices[device_count++];
+    }
+    xSemaphoreGive(devices_lock);
+
+    if (dev == NULL)
+        ESP_LOGE(TAG, "Cannot register device 0x%02x on bus %u", address, bus_idx);
+    return dev;
 }
 
 /**
  * Select the current i2c bus by index.
  * All following i2c operations will be directed at that bus.
  *
- * THE IMPLEMENTATION IS OPTIONAL ON SINGLE-BUS SETUPS (all sensors on the same
- * bus)
+ * Only affects the address-based sensirion_i2c_hal_read/write calls; drivers
+ * using device handles carry their bus with the handle.
  *
  * @param bus_idx   Bus index to select
  * @returns         0 on success, an error code otherwise
  */
 int16_t sensirion_i2c_hal_select_bus(uint8_t bus_idx) {
-    /* TODO:IMPLEMENT or leave empty if all sensors are located on one single
-     * bus
-     */
-    return 0;
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES || buses[bus_idx].handle == NULL)
+        return I2C_BUS_ERROR;
+    selected_bus = bus_idx;
+    return NO_ERROR;
 }
 
-/**
- * Initialize all hard- and software components that are needed for the I2C
- * communication.
+/*
+ * Reset dev's bus and give dev a fresh handle, with the bus held by the
+ * caller so the reset cuts no other device's transaction short. A
+ * transaction of dev that never completed is aborted, so nothing is left
+ * queued on the caller's buffers.
  */
-void sensirion_i2c_hal_init(void)
+static esp_err_t sensirion_i2c_hal_reset_held(sensirion_i2c_hal_device_t* dev)
+{
+    xSemaphoreTake(devices_lock, portMAX_DELAY);
+
+    // Resets the controller state machine and clocks SCL until a slave that
+    // was left holding SDA low in the middle of a byte lets go of it.
+    esp_err_t err = i2c_master_bus_reset(buses[dev->bus_idx].handle);
+    if (err == ESP_OK) {
+        HAL_STAT_INC(bus_resets);
+        // The aborted transaction can leave the device handle wedged, so
+        // replace it with a fresh one.
+        if (dev->handle != NULL) {
+            i2c_master_bus_rm_device(dev->handle);
+            dev->handle = NULL;
+        }
+        err = sensirion_i2c_hal_add_device(dev, dev->bus_idx, dev->address);
+        if (err == ESP_OK)
+            HAL_STAT_INC(device_readds);
+    }
+
+    xSemaphoreGive(devices_lock);
+    // The aborted transaction may have signalled its end on the way out.
+    xSemaphoreTake(dev->done, 0);
+
+    if (err != ESP_OK) {
+        HAL_STAT_INC(recovery_failures);
+        ESP_LOGE(TAG, "Recovery of device 0x%02x on bus %u failed: %s",
+                 dev->address, dev->bus_idx, esp_err_to_name(err));
+    } else {
+        ESP_LOGW(TAG, "Bus %u reset, device 0x%02x re-added", dev->bus_idx, dev->address);
+    }
+    return err;
+}
+
+int16_t sensirion_i2c_hal_recover(sensirion_i2c_hal_device_t* dev)
+{
+    if (dev == NULL)
+        return I2C_BUS_ERROR;
+
+    // Hold the bus so the reset cuts no other transaction short. A holder
+    // whose completion never arrived is overridden; the reset aborts it.
+    if (!sensirion_i2c_hal_bus_acquire(dev)) {
+        if (xSemaphoreTake(buses[dev->bus_idx].lock, 0) != pdTRUE) {
+            portENTER_CRITICAL(&bus_lock_mux);
+            buses[dev->bus_idx].stats.takeovers++;
+            portEXIT_CRITICAL(&bus_lock_mux);
+            ESP_LOGW(TAG, "Bus %u held past its transaction; taking it over", dev->bus_idx);
+        }
+        sensirion_i2c_hal_bus_granted(dev, esp_timer_get_time(), true);
+    }
+
+    esp_err_t err = sensirion_i2c_hal_reset_held(dev);
+    sensirion_i2c_hal_bus_release(dev);
+    return err == ESP_OK ? NO_ERROR : I2C_BUS_ERROR;
+}
+
+void sensirion_i2c_hal_get_stats(sensirion_i2c_hal_stats_t* out)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+int16_t sensirion_i2c_hal_get_bus_stats(uint8_t bus_idx,
+                                        sensirion_i2c_hal_bus_stats_t* out)
+{
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES || buses[bus_idx].handle == NULL)
+        return I2C_BUS_ERROR;
+    portENTER_CRITICAL(&bus_lock_mux);
+    *out = buses[bus_idx].stats;
+    portEXIT_CRITICAL(&bus_lock_mux);
+    return NO_ERROR;
+}
+
+void sensirion_i2c_hal_reset_bus_stats(uint8_t bus_idx)
+{
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES)
+        return;
+    portENTER_CRITICAL(&bus_lock_mux);
+    memset(&buses[bus_idx].stats, 0, sizeof(buses[bus_idx].stats));
+    buses[bus_idx].stats.since_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&bus_lock_mux);
+}
+
+void sensirion_i2c_hal_get_device_stats(const sensirion_i2c_hal_device_t* dev,
+                                        sensirion_i2c_hal_device_stats_t* out)
+{
+    if (dev == NULL) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    portENTER_CRITICAL(&bus_lock_mux);
+    *out = dev->bus_stats;
+    portEXIT_CRITICAL(&bus_lock_mux);
+}
+
+void sensirion_i2c_hal_log_bus_stats(void)
+{
+    const int64_t now = esp_timer_get_time();
+    sensirion_i2c_hal_bus_stats_t s;
+
+    for (uint8_t i = 0; i < SENSIRION_I2C_HAL_MAX_BUSES; i++) {
+        if (sensirion_i2c_hal_get_bus_stats(i, &s) != NO_ERROR)
+            continue;
+        const int64_t span_us = now - s.since_us;
+        ESP_LOGI(TAG, "bus %u: %.2f%% busy, %lu tx, %lu contended, wait avg %llu us max %lu us, "
+                      "max hold %lu us, %lu wait timeouts, %lu takeovers",
+                 i, span_us > 0 ? 100.0 * s.busy_us / span_us : 0.0,
+                 (unsigned long)s.transactions, (unsigned long)s.contended,
+                 (unsigned long long)(s.transactions ? s.wait_us / s.transactions : 0),
+                 (unsigned long)s.max_wait_us, (unsigned long)s.max_hold_us,
+                 (unsigned long)s.wait_timeouts, (unsigned long)s.takeovers);
+    }
+}
+
+#if CONFIG_SEN66_I2C_PROFILE
+void sensirion_i2c_hal_get_profile(sensirion_i2c_hal_profile_t* out)
 {
+    portENTER_CRITICAL(&profile_lock);
+    *out = profile;
+    portEXIT_CRITICAL(&profile_lock);
+}
+
+void sensirion_i2c_hal_get_time_totals(uint64_t* bus_us, uint64_t* sleep_us)
+{
+    portENTER_CRITICAL(&profile_lock);
+    *bus_us = profile_bus_us;
+    *sleep_us = profile.sleep_us;
+    portEXIT_CRITICAL(&profile_lock);
+}
+
+void sensirion_i2c_hal_reset_profile(void)
+{
+    portENTER_CRITICAL(&profile_lock);
+    memset(&profile, 0, sizeof(profile));
+    profile_bus_us = 0;
+    portEXIT_CRITICAL(&profile_lock);
+}
+
+/* Upper bound of the bucket holding the given percentile. */
+static uint32_t sensirion_i2c_hal_profile_percentile(const uint32_t* latency,
+                                                     uint32_t total,
+                                                     uint32_t percent)
+{
+    const uint64_t rank = ((uint64_t)total * percent + 99) / 100;
+    uint64_t seen = 0;
+
+    for (uint8_t i = 0; i < SENSIRION_I2C_HAL_PROFILE_BUCKETS; i++) {
+        seen += latency[i];
+        if (seen >= rank)
+            return 1u << (i + 1);
+    }
+    return 1u << SENSIRION_I2C_HAL_PROFILE_BUCKETS;
+}
+
+void sensirion_i2c_hal_log_profile(void)
+{
+    // Too large for the stack of the esp_timer task; only one logger at a time.
+    static sensirion_i2c_hal_profile_t snapshot;
+
+    sensirion_i2c_hal_get_profile(&snapshot);
+    for (uint8_t i = 0; i < snapshot.opcode_count; i++) {
+        const sensirion_i2c_hal_opcode_profile_t *p = &snapshot.opcodes[i];
+        ESP_LOGI(TAG, "0x%04x: %lu tx, %lu err, %lu/%lu B, bus %llu us, p50 < %lu us, p99 < %lu us",
+                 p->opcode, (unsigned long)p->transactions, (unsigned long)p->errors,
+                 (unsigned long)p->tx_bytes, (unsigned long)p->rx_bytes,
+                 (unsigned long long)p->bus_us,
+                 (unsigned long)sensirion_i2c_hal_profile_percentile(p->latency, p->transactions, 50),
+                 (unsigned long)sensirion_i2c_hal_profile_percentile(p->latency, p->transactions, 99));
+    }
+    ESP_LOGI(TAG, "sleep: %lu calls, %llu us, p50 < %lu us, p99 < %lu us; %lu untracked tx",
+             (unsigned long)snapshot.sleeps, (unsigned long long)snapshot.sleep_us,
+             (unsigned long)sensirion_i2c_hal_profile_percentile(snapshot.sleep_latency, snapshot.sleeps, 50),
+             (unsigned long)sensirion_i2c_hal_profile_percentile(snapshot.sleep_latency, snapshot.sleeps, 99),
+             (unsigned long)snapshot.untracked);
+}
+#else
+void sensirion_i2c_hal_get_profile(sensirion_i2c_hal_profile_t* out)
+{
+    memset(out, 0, sizeof(*out));
+}
+
+void sensirion_i2c_hal_get_time_totals(uint64_t* bus_us, uint64_t* sleep_us)
+{
+    *bus_us = 0;
+    *sleep_us = 0;
+}
+
+void sensirion_i2c_hal_reset_profile(void)
+{
+}
+
+void sensirion_i2c_hal_log_profile(void)
+{
+}
+#endif
+
+int16_t sensirion_i2c_hal_init_bus(uint8_t bus_idx,
+                                   const sensirion_i2c_hal_bus_config_t* config)
+{
+    if (bus_idx >= SENSIRION_I2C_HAL_MAX_BUSES)
+        return I2C_BUS_ERROR;
+    if (buses[bus_idx].handle != NULL)
+        return NO_ERROR;
+
     i2c_master_bus_config_t i2c_mst_config = {
         .clk_source = I2C_CLK_SRC_DEFAULT,
-        .i2c_port = I2C_MASTER_NUM,
-        .scl_io_num = I2C_MASTER_SCL_IO,
-        .sda_io_num = I2C_MASTER_SDA_IO,
+        .i2c_port = bus_idx,
+        .scl_io_num = config->scl_io,
+        .sda_io_num = config->sda_io,
         .glitch_ignore_cnt = 7,
+        .trans_queue_depth = I2C_MASTER_TRANS_QUEUE_DEPTH,
         .flags.enable_internal_pullup = true,
     };
 
-    ESP_ERROR_CHECK(i2c_new_master_bus(&i2c_mst_config, &bus_handle));
+    if (devices_lock == NULL)
+        devices_lock = xSemaphoreCreateMutex();
+    sensirion_i2c_trace_init();
+
+    esp_err_t err = i2c_new_master_bus(&i2c_mst_config, &buses[bus_idx].handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "i2c_new_master_bus(%u) failed: %s", bus_idx, esp_err_to_name(err));
+        return I2C_BUS_ERROR;
+    }
+    buses[bus_idx].frequency_hz = config->frequency_hz;
+    if (buses[bus_idx].lock == NULL)
+        buses[bus_idx].lock = xSemaphoreCreateBinary();
+    buses[bus_idx].owner = NULL;
+    xSemaphoreGive(buses[bus_idx].lock);
+    sensirion_i2c_hal_reset_bus_stats(bus_idx);
+
+    ESP_LOGI(TAG, "I2C bus %u ready (SDA %d, SCL %d, %lu Hz)", bus_idx,
+             config->sda_io, config->scl_io, (unsigned long)config->frequency_hz);
+    return NO_ERROR;
+}
 
-    ESP_LOGI(TAG, "sensirion_i2c_hal_init:  i2c_new_master_bus completed.");
+/**
+ * Initialize all hard- and software components that are needed for the I2C
+ * communication.
+ *
+ * Brings up every bus enabled in menuconfig (Component config -> SEN66).
+ */
+void sensirion_i2c_hal_init(void)
+{
+    const sensirion_i2c_hal_bus_config_t bus0 = {
+        .sda_io = CONFIG_SEN66_I2C_BUS0_SDA_GPIO,
+        .scl_io = CONFIG_SEN66_I2C_BUS0_SCL_GPIO,
+        .frequency_hz = CONFIG_SEN66_I2C_FREQ_HZ,
+    };
+    ESP_ERROR_CHECK(sensirion_i2c_hal_init_bus(0, &bus0) == NO_ERROR ? ESP_OK : ESP_FAIL);
 
-    return;
+#if CONFIG_SEN66_I2C_BUS1_ENABLE
+    const sensirion_i2c_hal_bus_config_t bus1 = {
+        .sda_io = CONFIG_SEN66_I2C_BUS1_SDA_GPIO,
+        .scl_io = CONFIG_SEN66_I2C_BUS1_SCL_GPIO,
+        .frequency_hz = CONFIG_SEN66_I2C_FREQ_HZ,
+    };
+    ESP_ERROR_CHECK(sensirion_i2c_hal_init_bus(1, &bus1) == NO_ERROR ? ESP_OK : ESP_FAIL);
+#endif
 }
 
 /**
  * Release all resources initialized by sensirion_i2c_hal_init().
  */
 void sensirion_i2c_hal_free(void) {
-    /* TODO:IMPLEMENT or leave empty if no resources need to be freed */
+    xSemaphoreTake(devices_lock, portMAX_DELAY);
+    for (uint8_t i = 0; i < device_count; i++) {
+        i2c_master_bus_rm_device(devices[i].handle);
+        devices[i].handle = NULL;
+    }
+    device_count = 0;
+    xSemaphoreGive(devices_lock);
+
+    for (uint8_t i = 0; i < SENSIRION_I2C_HAL_MAX_BUSES; i++) {
+        if (buses[i].handle != NULL) {
+            i2c_del_master_bus(buses[i].handle);
+            buses[i].handle = NULL;
+        }
+        if (buses[i].lock != NULL) {
+            vSemaphoreDelete(buses[i].lock);
+            buses[i].lock = NULL;
+        }
+    }
+    selected_bus = 0;
 }
 
 /**
@@ -84,13 +626,8 @@ void sensirion_i2c_hal_free(void) {
  */
 int8_t sensirion_i2c_hal_read(uint8_t address, uint8_t* data, uint8_t count)
 {
-    if (dev_handle == NULL)
-        dev_handle = sensirion_i2c_hal_add_device(address);
-
-    esp_err_t status = i2c_master_receive(dev_handle, data, count, -1);
-    ESP_ERROR_CHECK(status);
-
-    return status;
+    return sensirion_i2c_hal_device_read(
+        sensirion_i2c_hal_get_device(selected_bus, address), data, count);
 }
 
 /**
@@ -106,12 +643,124 @@ int8_t sensirion_i2c_hal_read(uint8_t address, uint8_t* data, uint8_t count)
  */
 int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t* data, uint8_t count)
 {
-    if (dev_handle == NULL)
-        dev_handle = sensirion_i2c_hal_add_device(address);
+    return sensirion_i2c_hal_device_write(
+        sensirion_i2c_hal_get_device(selected_bus, address), data, count);
+}
+
+/*
+ * One attempt at a blocking transfer: tx is written, rx read, both in one
+ * transaction when given together. A completion that never arrives counts
+ * as a timeout. A bus error or timeout resets the bus before it is handed
+ * on, so no transaction is left queued on the caller's buffers.
+ */
+static int8_t sensirion_i2c_hal_transfer_once(sensirion_i2c_hal_device_t* dev,
+                                              uint8_t* rx, uint8_t rx_count,
+                                              const uint8_t* tx, uint8_t tx_count)
+{
+    esp_err_t err;
+    int8_t status;
+
+    if (dev->handle == NULL)
+        return I2C_BUS_ERROR;
+    if (!sensirion_i2c_hal_bus_acquire(dev)) {
+        // Every transaction holds the bus for at most its timeout, so the
+        // holder is stuck; take the bus over and reset it.
+        sensirion_i2c_hal_recover(dev);
+        return I2C_BUS_ERROR;
+    }
+
+    const uint32_t start_us = HAL_NOW();
+    // Drop a completion left over from a transaction the reset aborted.
+    xSemaphoreTake(dev->done, 0);
+
+    if (rx != NULL && tx != NULL)
+        err = i2c_master_transmit_receive(dev->handle, tx, tx_count, rx, rx_count, -1);
+    else if (rx != NULL)
+        err = i2c_master_receive(dev->handle, rx, rx_count, -1);
+    else
+        err = i2c_master_transmit(dev->handle, tx, tx_count, -1);
+    if (err != ESP_OK) {
+        HAL_STAT_INC(bus_errors);
+        status = I2C_BUS_ERROR;
+    } else if (xSemaphoreTake(dev->done, pdMS_TO_TICKS(CONFIG_SEN66_I2C_TIMEOUT_MS)) != pdTRUE) {
+        HAL_STAT_INC(timeout_errors);
+        status = I2C_BUS_ERROR;
+    } else {
+        status = dev->status;
+    }
+    if (status == I2C_BUS_ERROR)
+        sensirion_i2c_hal_reset_held(dev);
+    sensirion_i2c_hal_bus_release(dev);
+
+    if (tx != NULL)
+        HAL_INSTRUMENT(dev, SENSIRION_I2C_TRACE_WRITE, tx, tx_count, status, start_us);
+    if (rx != NULL)
+        HAL_INSTRUMENT(dev,
+                       dev->polling ? SENSIRION_I2C_TRACE_POLL_READ : SENSIRION_I2C_TRACE_READ,
+                       rx, rx_count, status, start_us);
+    return status;
+}
+
+/*
+ * Blocking transfer with bounded retries. A NACK usually means the sensor is
+ * still busy and is simply retried after the backoff; after bus errors and
+ * timeouts the failed attempt has already reset the bus.
+ */
+static int8_t sensirion_i2c_hal_transfer(sensirion_i2c_hal_device_t* dev,
+                                         uint8_t* rx, uint8_t rx_count,
+                                         const uint8_t* tx, uint8_t tx_count)
+{
+    int8_t status;
+
+    if (dev == NULL)
+        return I2C_BUS_ERROR;
+
+    for (uint8_t attempt = 0;; attempt++) {
+        status = sensirion_i2c_hal_transfer_once(dev, rx, rx_count, tx, tx_count);
+        if (status == NO_ERROR || attempt >= CONFIG_SEN66_I2C_MAX_RETRIES)
+            break;
+
+        HAL_STAT_INC(retries);
+        sensirion_i2c_hal_sleep_usec(I2C_MASTER_BACKOFF_BASE_US << attempt);
+    }
+
+    if (status != NO_ERROR)
+        ESP_LOGW(TAG, "%s of device 0x%02x on bus %u failed: %d",
+                 tx == NULL ? "Read" : rx == NULL ? "Write" : "Write-read",
+                 dev->address, dev->bus_idx, status);
+    return status;
+}
+
+int8_t sensirion_i2c_hal_device_read(sensirion_i2c_hal_device_t* dev,
+                                     uint8_t* data, uint8_t count)
+{
+    return sensirion_i2c_hal_transfer(dev, data, count, NULL, 0);
+}
+
+int8_t sensirion_i2c_hal_device_write(sensirion_i2c_hal_device_t* dev,
+                                      const uint8_t* data, uint8_t count)
+{
+    return sensirion_i2c_hal_transfer(dev, NULL, 0, data, count);
+}
+
+int8_t sensirion_i2c_hal_device_write_read(sensirion_i2c_hal_device_t* dev,
+                                           const uint8_t* tx, uint8_t tx_count,
+                                           uint8_t* rx, uint8_t rx_count)
+{
+    return sensirion_i2c_hal_transfer(dev, rx, rx_count, tx, tx_count);
+}
+
+int8_t sensirion_i2c_hal_device_poll_read(sensirion_i2c_hal_device_t* dev,
+                                          uint8_t* data, uint8_t count)
+{
+    int8_t status;
 
-    esp_err_t status = i2c_master_transmit(dev_handle, data, count, -1);
-    ESP_ERROR_CHECK(status);
+    if (dev == NULL)
+        return I2C_BUS_ERROR;
 
+    dev->polling = true;
+    status = sensirion_i2c_hal_transfer_once(dev, data, count, NULL, 0);
+    dev->polling = false;
     return status;
 }
 
@@ -119,10 +768,46 @@ int8_t sensirion_i2c_hal_write(uint8_t address, const uint8_t* data, uint8_t cou
  * Sleep for a given number of microseconds. The function should delay the
  * execution for at least the given time, but may also sleep longer.
  *
- * Despite the unit, a <10 millisecond precision is sufficient.
+ * Whole scheduler ticks are spent in vTaskDelay() so other tasks on this core
+ * (Matter, Wi-Fi) can run; only the sub-tick remainder is busy-waited.
  *
  * @param useconds the sleep time in microseconds
  */
 void sensirion_i2c_hal_sleep_usec(uint32_t useconds) {
-    esp_rom_delay_us(useconds);
+#if CONFIG_SEN66_I2C_PROFILE
+    const uint32_t start_us = HAL_NOW();
+    sensirion_i2c_hal_sleep(useconds);
+    const uint32_t slept_us = HAL_NOW() - start_us;
+
+    portENTER_CRITICAL(&profile_lock);
+    profile.sleeps++;
+    profile.sleep_us += slept_us;
+    profile.sleep_latency[sensirion_i2c_hal_profile_bucket(slept_us)]++;
+    portEXIT_CRITICAL(&profile_lock);
+#else
+    sensirion_i2c_hal_sleep(useconds);
+#endif
+}
+
+static void sensirion_i2c_hal_sleep(uint32_t useconds) {
+    const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+        esp_rom_delay_us(useconds);
+        return;
+    }
+
+    const int64_t deadline = esp_timer_get_time() + useconds;
+    int64_t remaining = useconds;
+
+    // vTaskDelay(n) may return up to one tick early, so re-check the clock
+    // and keep yielding until less than a tick is left.
+    while (remaining >= tick_us) {
+        vTaskDelay((TickType_t)(remaining / tick_us));
+        remaining = deadline - esp_timer_get_time();
+    }
+
+    if (remaining > 0) {
+        esp_rom_delay_us((uint32_t)remaining);
+    }
 }
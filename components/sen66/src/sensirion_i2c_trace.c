@@ -0,0 +1,166 @@
+#include "sensirion_i2c_trace.h"
+#include "sensirion_common.h"
+#include "sdkconfig.h"
+
+#if CONFIG_SEN66_I2C_TRACE
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "sensirion_i2c_trace";
+
+typedef struct {
+    _Atomic uint32_t seq; // claim index + 1 once complete, 0 while written
+    sensirion_i2c_trace_record_t record;
+    uint8_t data[SENSIRION_I2C_TRACE_MAX_DATA];
+} trace_slot_t;
+
+static trace_slot_t *ring = NULL;
+static _Atomic uint32_t head = 0; // next index to claim
+static _Atomic uint32_t tail = 0; // first index not cleared
+
+void sensirion_i2c_trace_init(void)
+{
+    if (ring != NULL)
+        return;
+
+    const size_t size = CONFIG_SEN66_I2C_TRACE_ENTRIES * sizeof(trace_slot_t);
+    ring = heap_caps_calloc(1, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (ring == NULL)
+        ring = heap_caps_calloc(1, size, MALLOC_CAP_8BIT);
+    if (ring == NULL) {
+        ESP_LOGE(TAG, "Cannot allocate %u bytes, tracing disabled", (unsigned)size);
+        return;
+    }
+    ESP_LOGI(TAG, "Recording the last %d I2C transactions (%u bytes)",
+             CONFIG_SEN66_I2C_TRACE_ENTRIES, (unsigned)size);
+}
+
+void sensirion_i2c_trace_record(uint8_t bus_idx, uint8_t address,
+                                sensirion_i2c_trace_dir_t dir,
+                                const uint8_t* data, uint8_t count,
+                                int8_t status, uint32_t timestamp_us,
+                                uint32_t duration_us)
+{
+    if (ring == NULL)
+        return;
+
+    uint32_t index = atomic_fetch_add_explicit(&head, 1, memory_order_relaxed);
+    trace_slot_t *slot = &ring[index % CONFIG_SEN66_I2C_TRACE_ENTRIES];
+
+    // Mark the slot as being written before touching it, so a concurrent
+    // export sees either the old record, the new one, or skips it.
+    atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    uint8_t length = 0;
+    if (dir == SENSIRION_I2C_TRACE_WRITE || status == NO_ERROR)
+        length = count < SENSIRION_I2C_TRACE_MAX_DATA ? count : SENSIRION_I2C_TRACE_MAX_DATA;
+
+    slot->record = (sensirion_i2c_trace_record_t){
+        .timestamp_us = timestamp_us,
+        .duration_us = duration_us,
+        .bus_idx = bus_idx,
+        .address = address,
+        .dir = (uint8_t)dir,
+        .status = status,
+        .count = count,
+        .length = length,
+    };
+    memcpy(slot->data, data, length);
+
+    atomic_store_explicit(&slot->seq, index + 1, memory_order_release);
+}
+
+uint32_t sensirion_i2c_trace_export(sensirion_i2c_trace_sink_t sink, void* arg)
+{
+    uint8_t buf[sizeof(sensirion_i2c_trace_record_t) + SENSIRION_I2C_TRACE_MAX_DATA];
+    uint32_t end = atomic_load_explicit(&head, memory_order_acquire);
+    uint32_t begin = atomic_load_explicit(&tail, memory_order_relaxed);
+    uint32_t written = 0;
+    uint32_t skipped = 0;
+
+    if (end - begin > CONFIG_SEN66_I2C_TRACE_ENTRIES)
+        begin = end - CONFIG_SEN66_I2C_TRACE_ENTRIES;
+
+    const sensirion_i2c_trace_file_header_t header = {
+        .magic = SENSIRION_I2C_TRACE_MAGIC,
+        .version = SENSIRION_I2C_TRACE_VERSION,
+        .record_size = sizeof(sensirion_i2c_trace_record_t),
+        .dropped = begin - atomic_load_explicit(&tail, memory_order_relaxed),
+    };
+    if (ring == NULL || !sink(&header, sizeof(header), arg))
+        return 0;
+
+    for (uint32_t index = begin; index != end; index++) {
+        const trace_slot_t *slot = &ring[index % CONFIG_SEN66_I2C_TRACE_ENTRIES];
+
+        // Copy, then check the slot was neither unfinished nor reused.
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != index + 1) {
+            skipped++;
+            continue;
+        }
+        sensirion_i2c_trace_record_t record = slot->record;
+        uint8_t length = record.length <= SENSIRION_I2C_TRACE_MAX_DATA ? record.length : 0;
+        record.length = length;
+        memcpy(buf, &record, sizeof(record));
+        memcpy(buf + sizeof(record), slot->data, length);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != index + 1) {
+            skipped++;
+            continue;
+        }
+
+        if (!sink(buf, sizeof(record) + length, arg))
+            break;
+        written++;
+    }
+
+    if (skipped > 0)
+        ESP_LOGW(TAG, "%lu records overwritten during export", (unsigned long)skipped);
+    return written;
+}
+
+void sensirion_i2c_trace_clear(void)
+{
+    atomic_store_explicit(&tail, atomic_load_explicit(&head, memory_order_acquire),
+                          memory_order_relaxed);
+}
+
+#else // CONFIG_SEN66_I2C_TRACE
+
+void sensirion_i2c_trace_init(void)
+{
+}
+
+void sensirion_i2c_trace_record(uint8_t bus_idx, uint8_t address,
+                                sensirion_i2c_trace_dir_t dir,
+                                const uint8_t* data, uint8_t count,
+                                int8_t status, uint32_t timestamp_us,
+                                uint32_t duration_us)
+{
+    (void)bus_idx;
+    (void)address;
+    (void)dir;
+    (void)data;
+    (void)count;
+    (void)status;
+    (void)timestamp_us;
+    (void)duration_us;
+}
+
+uint32_t sensirion_i2c_trace_export(sensirion_i2c_trace_sink_t sink, void* arg)
+{
+    (void)sink;
+    (void)arg;
+    return 0;
+}
+
+void sensirion_i2c_trace_clear(void)
+{
+}
+
+#endif // CONFIG_SEN66_I2C_TRACE
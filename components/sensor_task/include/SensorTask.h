@@ -1,27 +1,87 @@
 #pragma once
 #include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include "MatterAirQuality.h"
-#include <SmaFilter.h>
+#include "sen66_fan_cleaning.h"
+#include "sen66_supervisor.h"
+#include "sen6x_traits.h"
+#include "SpscRing.h"
+#include <FilterChain.h>
+#include <MultiChannelSma.h>
+#include <array>
+#include <functional>
 
 class SensorTask
 {
 public:
-    SensorTask(MatterAirQuality &aqCluster, uint64_t intervalUs = 5ULL * 1000 * 1000);
+    // sensorConfig is what the sensor was brought up with; the supervisor
+    // reapplies it after a device reset.
+    SensorTask(MatterAirQuality &aqCluster, const sen66_config_t &sensorConfig,
+               uint64_t intervalUs = 5ULL * 1000 * 1000);
     ~SensorTask();
 
-    // Start the periodic sensor reads
+    // Start the periodic sensor reads. Reads are phase-locked to the sensor's
+    // 1 Hz update, so each one lands up to one second after its nominal slot.
+    // The timer only wakes the acquisition task, which queues each sample to
+    // the publish task; both are created here with the core, priorities and
+    // stacks from menuconfig (CONFIG_SENSOR_TASK_*).
     void start();
 
     // Change the interval at runtime
     esp_err_t setInterval(uint64_t intervalUs);
 
+    // Extra frames per acquisition: number concentrations every ncEvery-th
+    // cycle and raw signals every rawEvery-th, 0 for never. Each frame adds
+    // about 3 ms of bus time to its cycle.
+    void setFrameSchedule(uint32_t ncEvery, uint32_t rawEvery);
+
+    // Receives every acquisition record, on the publish task. Set both
+    // before start().
+    using RecordCallback = std::function<void(const sen66_record_t &)>;
+    void setRecordCallback(RecordCallback callback) { mRecordCallback = std::move(callback); }
+
+    // Hand-over between the acquisition and publish stages. Each counter has
+    // a single writer task; the publish-side latency figures are copied under
+    // a lock so the average comes from a matching sum and count.
+    struct PipelineStats
+    {
+        uint32_t queued;       // samples handed to the publish stage
+        uint32_t published;    // samples the publish stage has processed
+        uint32_t overruns;     // samples dropped because the ring was full
+        uint32_t occupancy;    // samples waiting now
+        uint32_t maxOccupancy;
+        uint32_t avgLatencyUs; // queued until the publish stage took it
+        uint32_t maxLatencyUs;
+    };
+    PipelineStats pipelineStats() const;
+
 private:
-    // Timer callback and handler
+    // One acquisition, queued for the publish stage.
+    struct Sample
+    {
+        sen66_record_t record;
+        int64_t queuedUs;
+        bool pmBlanked;
+    };
+
+    // Timer callback, acquisition and publish tasks and their stages
     static void timerCallback(void *arg);
-    void handleTimer();
+    static void taskEntry(void *arg);
+    static void publishEntry(void *arg);
+    void run();
+    void publishLoop();
+    void acquire();
+    void publish(const Sample &sample);
+    esp_err_t scheduleNext();
+    void profileCycle(int64_t cycleStartUs, uint64_t busStartUs, uint64_t sleepStartUs);
+    void snapshotVocState();
+    void logLatency();
+    uint8_t framesForCycle();
 
     // Helper methods
-    void smoothSensorData(sen66_data_t &smooth);
+    static bool validReading(sen6x::Channel channel, float value);
+    void smoothSensorData(sen66_data_t &smooth, bool pmBlanked);
     bool shouldReport(const sen66_data_t &smooth) const;
     void logChanges(const sen66_data_t &smooth, const sen66_data_t &old) const;
     void saveLastPublishedToNVS() const;
@@ -30,7 +90,71 @@ private:
     MatterAirQuality &mAqCluster;
     uint64_t mIntervalUs;
     esp_timer_handle_t mTimer;
+    TaskHandle_t mTask = nullptr;
+    TaskHandle_t mPublishTask = nullptr;
+
+    // 40 s of samples at the default interval; a fuller ring drops the newest.
+    SpscRing<Sample, 8> mSamples;
+    uint32_t mQueued = 0;       // written by the acquisition task
+    uint32_t mOverruns = 0;
+    uint32_t mMaxOccupancy = 0;
+    // Written by the publish task under mLatencyLock: the 64-bit sum would
+    // tear on this 32-bit target, and it must stay paired with the count.
+    mutable portMUX_TYPE mLatencyLock = portMUX_INITIALIZER_UNLOCKED;
+    uint32_t mPublished = 0;
+    uint64_t mQueueLatencyUs = 0;
+    uint32_t mMaxQueueLatencyUs = 0;
+    int64_t mNextDueUs = 0; // nominal time of the next read
+    int64_t mReadAtUs = 0;  // phase-locked time of the next read
+    uint32_t mMissedCycles = 0; // the bus was not granted before the next slot
+    bool mHadSample = false; // for the boot-to-first-sample log
+    Sen66PhaseLock mPhaseLock;
+    Sen66Supervisor mSupervisor;
+    Sen66FanCleaning mFanCleaning;
+
+    // Bus time reserved per read: a locked cycle takes well under 100 ms, a
+    // relock polls for up to one update period.
+    static constexpr uint32_t kLockedReadUs = 100 * 1000;
+    static constexpr uint32_t kRelockReadUs = 1300 * 1000;
+
+    // Timer dispatch (read slot to callback) and wake-up (callback to the
+    // acquisition task running) latency, logged every kLatencyLogCycles.
+    struct Latency
+    {
+        uint32_t count = 0;
+        int64_t sumUs = 0;
+        int64_t maxUs = 0;
+
+        void add(int64_t us)
+        {
+            count++;
+            sumUs += us;
+            if (us > maxUs)
+                maxUs = us;
+        }
+    };
+    static constexpr uint32_t kLatencyLogCycles = 60;
+    volatile int64_t mFiredUs = 0; // set by the timer callback
+    Latency mDispatchLatency;
+    Latency mWakeLatency;
+
+    // VOC algorithm state snapshots (sen66_voc_state.h)
+    static constexpr int64_t kVocSnapshotIntervalUs = 60LL * 1000 * 1000;
+    int64_t mVocSnapshotUs = 0;
+    bool mVocValid = false; // the last acquisition had a VOC index
+
+    // Acquisition time split, accumulated between profile dumps
+    static constexpr uint32_t kProfileLogCycles = 60;
+    uint32_t mProfileCycles = 0;
+    uint64_t mProfileCycleUs = 0;
+    uint64_t mProfileBusUs = 0;
+    uint64_t mProfileSleepUs = 0;
     sen66_data_t mLatestData;
+    sen66_record_t mLatestRecord;
+    RecordCallback mRecordCallback;
+    uint32_t mCycle = 0;
+    uint32_t mNcEvery = 12; // once a minute at the default interval
+    uint32_t mRawEvery = 0;
     sen66_data_t mLastPublished{};
 
     // Thresholds for reporting
@@ -39,9 +163,26 @@ private:
     static constexpr float kCo2Threshold = 50.0f; // ppm
     static constexpr float kVocThreshold = 10.0f; // ppb
     static constexpr float kNoxThreshold = 5.0f;  // ppb
+    static constexpr float kHchoThreshold = 10.0f; // ppb
     static constexpr float kTempThreshold = 0.5f; // °C
     static constexpr float kHumThreshold = 2.0f;  // %
 
-    // Filters for smoothing data
-    SmaFilter pm1_filter{5}, pm25_filter{5}, pm10_filter{5};
+    // Smoothing per channel, fixed at compile time (FilterChain.h). The
+    // median stages drop single-sample spikes before they reach a threshold.
+    // The PM channels share one moving average, indexed by PmChannel, behind
+    // a per-channel median that drops spikes of up to two samples (insects,
+    // dust puffs) before the average can smear them into a report.
+    enum PmChannel : size_t { kPm1, kPm25, kPm10, kPmChannels };
+    using PmSpikeFilter = filters::Chain<filters::Median<5>>;
+    using PmFilter = MultiChannelSma<kPmChannels, 4>;
+    using Co2Filter = filters::Chain<filters::Median<3>, filters::Ema<1, 4>>;
+    using IndexFilter = filters::Chain<filters::Ema<1, 2>>; // VOC/NOx: smoothed on the sensor already
+    using ClimateFilter = filters::Chain<filters::Ema<1, 3>>;
+    using HchoFilter = filters::Chain<filters::Median<3>, filters::Ema<1, 4>>;
+    std::array<PmSpikeFilter, kPmChannels> mPmSpikeFilters;
+    PmFilter mPmFilter;
+    Co2Filter mCo2Filter;
+    IndexFilter mVocFilter, mNoxFilter;
+    ClimateFilter mTempFilter, mHumFilter;
+    HchoFilter mHchoFilter;
 };
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-capacity ring for exactly one producer and one consumer task. Neither
+// side locks or blocks: push() fails when the ring is full and pop() when it
+// is empty. Items are copied in and out, so T should be a small POD record.
+//
+// The indices run freely and are reduced modulo N on access; the producer
+// publishes a slot with a release store of mHead, the consumer frees it with
+// a release store of mTail.
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert(N != 0 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer only.
+    bool push(const T &item)
+    {
+        const uint32_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) == N)
+            return false;
+        mItems[head % N] = item;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.
+    bool pop(T &item)
+    {
+        const uint32_t tail = mTail.load(std::memory_order_relaxed);
+        if (mHead.load(std::memory_order_acquire) == tail)
+            return false;
+        item = mItems[tail % N];
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Items waiting; exact from either side, a snapshot from anywhere else.
+    size_t size() const
+    {
+        return mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return N; }
+
+private:
+    T mItems[N];
+    std::atomic<uint32_t> mHead{0};
+    std::atomic<uint32_t> mTail{0};
+};
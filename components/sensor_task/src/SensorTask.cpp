@@ -1,19 +1,27 @@
 #include "SensorTask.h"
 #include <esp_log.h>
 #include <cmath>
-#include <SmaFilter.h>
 #include "nvs_flash.h"
 #include "nvs.h"
+#include "sdkconfig.h"
+#include "sen66_async.h"
+#include "sen66_fan_cleaning.h"
+#include "sen66_voc_state.h"
+#include "sensirion_common.h"
+#include "sensirion_i2c_hal.h"
 
 static const char *TAG = "SensorTask";
 
 static const char *NVS_NAMESPACE = "aq_task";
 static const char *NVS_KEY_LAST = "lastValues";
 
-SensorTask::SensorTask(MatterAirQuality &aqCluster, uint64_t intervalUs)
+SensorTask::SensorTask(MatterAirQuality &aqCluster, const sen66_config_t &sensorConfig, uint64_t intervalUs)
     : mAqCluster(aqCluster),
       mIntervalUs(intervalUs),
-      mTimer(nullptr)
+      mTimer(nullptr),
+      mSupervisor(sen66_default_ctx(), sensorConfig),
+      mFanCleaning(sen66_default_ctx(), CONFIG_SEN66_FAN_CLEANING_PERIOD_DAYS,
+                   CONFIG_SEN66_FAN_CLEANING_WINDOW_START_HOUR, CONFIG_SEN66_FAN_CLEANING_WINDOW_HOURS)
 {
 
     // Open our namespace
@@ -40,46 +48,267 @@ SensorTask::SensorTask(MatterAirQuality &aqCluster, uint64_t intervalUs)
 
 SensorTask::~SensorTask()
 {
+    // The timer notifies the acquisition task, which notifies the publish
+    // task; tear down in that order.
     if (mTimer)
     {
         esp_timer_stop(mTimer);
         esp_timer_delete(mTimer);
     }
+    if (mTask)
+        vTaskDelete(mTask);
+    if (mPublishTask)
+        vTaskDelete(mPublishTask);
 }
 
 void SensorTask::start()
 {
-    ESP_ERROR_CHECK(esp_timer_start_periodic(mTimer, mIntervalUs));
-    ESP_LOGI(TAG, "SensorTask started @ %lluus", mIntervalUs);
+    if (sen66_async_init() != NO_ERROR)
+        ESP_LOGW(TAG, "SEN66 bus arbiter unavailable; waiting for the bus will fail");
+
+    // Core -1, or one the chip does not have, leaves the task unpinned.
+    const BaseType_t core = CONFIG_SENSOR_TASK_CORE >= 0 && CONFIG_SENSOR_TASK_CORE < portNUM_PROCESSORS
+                                ? CONFIG_SENSOR_TASK_CORE
+                                : tskNO_AFFINITY;
+    if (xTaskCreatePinnedToCore(&SensorTask::publishEntry, "sensor_publish", CONFIG_SENSOR_TASK_PUBLISH_STACK_SIZE,
+                                this, CONFIG_SENSOR_TASK_PUBLISH_PRIORITY, &mPublishTask, core) != pdPASS ||
+        xTaskCreatePinnedToCore(&SensorTask::taskEntry, "sensor_task", CONFIG_SENSOR_TASK_STACK_SIZE, this,
+                                CONFIG_SENSOR_TASK_PRIORITY, &mTask, core) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create the acquisition tasks");
+        return;
+    }
+
+    mNextDueUs = esp_timer_get_time();
+    ESP_ERROR_CHECK(scheduleNext());
+    ESP_LOGI(TAG, "SensorTask started @ %lluus (core %d, priority %d)", mIntervalUs,
+             CONFIG_SENSOR_TASK_CORE, CONFIG_SENSOR_TASK_PRIORITY);
 }
 
 esp_err_t SensorTask::setInterval(uint64_t intervalUs)
 {
     mIntervalUs = intervalUs;
-    return esp_timer_stop(mTimer) == ESP_OK
-               ? esp_timer_start_periodic(mTimer, mIntervalUs)
-               : ESP_FAIL;
+    if (esp_timer_stop(mTimer) != ESP_OK)
+        return ESP_FAIL;
+    mNextDueUs = esp_timer_get_time();
+    return scheduleNext();
 }
 
+void SensorTask::setFrameSchedule(uint32_t ncEvery, uint32_t rawEvery)
+{
+    mNcEvery = ncEvery;
+    mRawEvery = rawEvery;
+}
+
+uint8_t SensorTask::framesForCycle()
+{
+    uint8_t frames = SEN66_FRAME_VALUES;
+    if (mNcEvery != 0 && mCycle % mNcEvery == 0)
+        frames |= SEN66_FRAME_NUMBER_CONCENTRATIONS;
+    if (mRawEvery != 0 && mCycle % mRawEvery == 0)
+        frames |= SEN66_FRAME_RAW;
+    mCycle++;
+    return frames;
+}
+
+// The timer runs one-shot: each read is placed just after the sensor's next
+// update following the nominal slot, instead of on a free-running period.
+// The slot is reserved with the bus arbiter so maintenance only gets the bus
+// in the gaps between reads.
+esp_err_t SensorTask::scheduleNext()
+{
+    int64_t now = esp_timer_get_time();
+    mNextDueUs += mIntervalUs;
+    if (mNextDueUs < now)
+        mNextDueUs = now; // a slow cycle; don't try to catch up
+
+    mReadAtUs = mPhaseLock.nextReadUs(mNextDueUs);
+    sen66_async_reserve(mReadAtUs, mPhaseLock.locked() ? kLockedReadUs : kRelockReadUs);
+    return esp_timer_start_once(mTimer, mReadAtUs > now ? mReadAtUs - now : 0);
+}
+
+// Runs on the esp_timer task, which every other timer in the system (Wi-Fi,
+// Matter, the SEN66 bus arbiter) shares, so it only hands the cycle over.
 void SensorTask::timerCallback(void *arg)
 {
-    static_cast<SensorTask *>(arg)->handleTimer();
+    auto *self = static_cast<SensorTask *>(arg);
+    self->mFiredUs = esp_timer_get_time();
+    xTaskNotifyGive(self->mTask);
+}
+
+void SensorTask::taskEntry(void *arg)
+{
+    static_cast<SensorTask *>(arg)->run();
+}
+
+void SensorTask::publishEntry(void *arg)
+{
+    static_cast<SensorTask *>(arg)->publishLoop();
+}
+
+// The acquisition task: one cycle per timer notification. It only talks to
+// the sensor and queues the sample, so a slow Matter update or NVS commit on
+// the publish task never delays the next read.
+void SensorTask::run()
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        const int64_t firedUs = mFiredUs;
+        mDispatchLatency.add(firedUs - mReadAtUs);
+        mWakeLatency.add(esp_timer_get_time() - firedUs);
+
+        // A maintenance lease that overran its gap still owns the bus; wait
+        // for it, but not past the next slot. The measurement grant is queued
+        // ahead of other maintenance.
+        int16_t granted = sen66_async_try_acquire(SEN66_ASYNC_PRIORITY_MEASUREMENT, mReadAtUs);
+        if (granted != NO_ERROR)
+            granted = sen66_async_acquire(SEN66_ASYNC_PRIORITY_MEASUREMENT, mReadAtUs + mIntervalUs);
+        if (granted != NO_ERROR)
+        {
+            mMissedCycles++;
+            ESP_LOGE(TAG, "Bus not granted (%d); cycle missed (%lu so far)", granted,
+                     (unsigned long)mMissedCycles);
+            if (scheduleNext() != ESP_OK)
+                ESP_LOGE(TAG, "Failed to schedule next sensor read");
+            continue;
+        }
+
+        acquire();
+        snapshotVocState();
+        esp_err_t err = scheduleNext();
+        sen66_async_release();
+        if (err != ESP_OK)
+            ESP_LOGE(TAG, "Failed to schedule next sensor read");
+        logLatency();
+    }
+}
+
+// The publish task: drains the ring after every queued sample.
+void SensorTask::publishLoop()
+{
+    Sample sample;
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (mSamples.pop(sample))
+        {
+            const uint32_t latencyUs = uint32_t(esp_timer_get_time() - sample.queuedUs);
+            publish(sample);
+            portENTER_CRITICAL(&mLatencyLock);
+            mQueueLatencyUs += latencyUs;
+            if (latencyUs > mMaxQueueLatencyUs)
+                mMaxQueueLatencyUs = latencyUs;
+            mPublished++;
+            portEXIT_CRITICAL(&mLatencyLock);
+        }
+    }
+}
+
+SensorTask::PipelineStats SensorTask::pipelineStats() const
+{
+    portENTER_CRITICAL(&mLatencyLock);
+    const uint32_t published = mPublished;
+    const uint64_t latencyUs = mQueueLatencyUs;
+    const uint32_t maxLatencyUs = mMaxQueueLatencyUs;
+    portEXIT_CRITICAL(&mLatencyLock);
+
+    return {mQueued,
+            published,
+            mOverruns,
+            uint32_t(mSamples.size()),
+            mMaxOccupancy,
+            published ? uint32_t(latencyUs / published) : 0,
+            maxLatencyUs};
+}
+
+void SensorTask::logLatency()
+{
+    if (mDispatchLatency.count < kLatencyLogCycles)
+        return;
+    ESP_LOGI(TAG, "Timer dispatch avg %lld us, max %lld us; task wake avg %lld us, max %lld us; stack free %u B",
+             (long long)(mDispatchLatency.sumUs / mDispatchLatency.count), (long long)mDispatchLatency.maxUs,
+             (long long)(mWakeLatency.sumUs / mWakeLatency.count), (long long)mWakeLatency.maxUs,
+             (unsigned)uxTaskGetStackHighWaterMark(nullptr));
+    const PipelineStats pipeline = pipelineStats();
+    ESP_LOGI(TAG, "Samples queued %lu, published %lu, overruns %lu; ring %lu/%u (max %lu); publish latency avg %lu us, max %lu us",
+             (unsigned long)pipeline.queued, (unsigned long)pipeline.published, (unsigned long)pipeline.overruns,
+             (unsigned long)pipeline.occupancy, (unsigned)mSamples.capacity(), (unsigned long)pipeline.maxOccupancy,
+             (unsigned long)pipeline.avgLatencyUs, (unsigned long)pipeline.maxLatencyUs);
+    mDispatchLatency = {};
+    mWakeLatency = {};
 }
 
-void SensorTask::handleTimer()
+// Acquisition stage: runs with the bus leased.
+void SensorTask::acquire()
 {
-    if (!mAqCluster.ReadSensor(&mLatestData))
+    // The sensor is idle while its fan is cleaned; nothing to acquire.
+    if (!mFanCleaning.onCycle())
+        return;
+
+    const int64_t cycleStartUs = esp_timer_get_time();
+    uint64_t busStartUs, sleepStartUs;
+    sensirion_i2c_hal_get_time_totals(&busStartUs, &sleepStartUs);
+
+    const bool ok = mAqCluster.ReadSensor(&mLatestRecord, mPhaseLock, framesForCycle());
+    profileCycle(cycleStartUs, busStartUs, sleepStartUs);
+    // Status checks and any recovery step share this cycle's bus lease.
+    mSupervisor.onCycle(ok);
+    mVocValid = ok && mLatestRecord.voc_index != INT16_MAX; // 0x7FFF marks it invalid
+    if (!ok)
     {
         ESP_LOGW(TAG, "SensorTask: ReadSensor failed");
         return;
     }
+    const bool pmBlanked = mFanCleaning.pmBlanked(mLatestRecord.timestamp_us);
+    if (pmBlanked)
+        sen66_record_blank_pm(&mLatestRecord);
+    if (!mHadSample)
+    {
+        // esp_timer counts from early boot, so this is boot-to-first-sample.
+        ESP_LOGI(TAG, "First sample %lld ms after boot", (long long)(esp_timer_get_time() / 1000));
+        mHadSample = true;
+    }
+    if (!mPhaseLock.locked())
+    {
+        ESP_LOGD(TAG, "Sensor phase not locked yet (hits %lu, misses %lu)",
+                 (unsigned long)mPhaseLock.hits(), (unsigned long)mPhaseLock.misses());
+    }
+
+    // The publish task may still be busy with an earlier sample; never wait
+    // for it.
+    const Sample sample{mLatestRecord, esp_timer_get_time(), pmBlanked};
+    if (!mSamples.push(sample))
+    {
+        mOverruns++;
+        ESP_LOGW(TAG, "Publish stage %u samples behind; dropping this one", (unsigned)mSamples.capacity());
+        return;
+    }
+    mQueued++;
+    const uint32_t occupancy = mSamples.size();
+    if (occupancy > mMaxOccupancy)
+        mMaxOccupancy = occupancy;
+    xTaskNotifyGive(mPublishTask);
+}
 
-    if (!std::isfinite(mLatestData.pm1_0) ||
-        !std::isfinite(mLatestData.pm2_5) ||
-        !std::isfinite(mLatestData.pm10_0) ||
-        !std::isfinite(mLatestData.co2_equivalent) ||
-        !std::isfinite(mLatestData.voc_index) ||
-        !std::isfinite(mLatestData.nox_index) ||
+// Publish stage: validation, smoothing, reporting and persistence of one
+// sample, on the publish task.
+void SensorTask::publish(const Sample &sample)
+{
+    const bool pmBlanked = sample.pmBlanked;
+    sen66_record_to_data(&sample.record, &mLatestData);
+    if (mRecordCallback)
+        mRecordCallback(sample.record);
+
+    const bool pmValid = pmBlanked ||
+                         (std::isfinite(mLatestData.pm1_0) &&
+                          std::isfinite(mLatestData.pm2_5) &&
+                          std::isfinite(mLatestData.pm10_0));
+    if (!pmValid ||
+        !validReading(sen6x::CO2, mLatestData.co2_equivalent) ||
+        !validReading(sen6x::VOC_INDEX, mLatestData.voc_index) ||
+        !validReading(sen6x::NOX_INDEX, mLatestData.nox_index) ||
+        !validReading(sen6x::HCHO, mLatestData.hcho) ||
         !std::isfinite(mLatestData.temperature) ||
         !std::isfinite(mLatestData.humidity))
     {
@@ -88,7 +317,7 @@ void SensorTask::handleTimer()
     }
 
     sen66_data_t smooth;
-    smoothSensorData(smooth);
+    smoothSensorData(smooth, pmBlanked);
 
     if (!shouldReport(smooth))
     {
@@ -102,26 +331,97 @@ void SensorTask::handleTimer()
     saveLastPublishedToNVS();
 }
 
-void SensorTask::smoothSensorData(sen66_data_t &smooth)
+// Copies the VOC algorithm state to RTC memory (and periodically NVS) so a
+// restart resumes the VOC index instead of relearning it. Runs while the bus
+// is leased, once the sensor reports a valid VOC index.
+void SensorTask::snapshotVocState()
+{
+    const int64_t now = esp_timer_get_time();
+    if (!mVocValid || now - mVocSnapshotUs < kVocSnapshotIntervalUs)
+        return;
+    if (sen66_voc_state_snapshot(sen66_default_ctx()) == NO_ERROR)
+        mVocSnapshotUs = now;
+}
+
+// Splits the acquisition into I2C transaction time, HAL sleeps and the rest
+// (CPU, scheduling), and dumps the per-opcode bus profile and the bus
+// arbitration counters every kProfileLogCycles cycles. Only active with
+// CONFIG_SEN66_I2C_PROFILE.
+void SensorTask::profileCycle(int64_t cycleStartUs, uint64_t busStartUs, uint64_t sleepStartUs)
 {
-    smooth.co2_equivalent = mLatestData.co2_equivalent;
-    smooth.voc_index = mLatestData.voc_index;
-    smooth.nox_index = mLatestData.nox_index;
-    smooth.temperature = mLatestData.temperature;
-    smooth.humidity = mLatestData.humidity;
-    smooth.pm1_0 = pm1_filter.addSample(mLatestData.pm1_0);
-    smooth.pm2_5 = pm25_filter.addSample(mLatestData.pm2_5);
-    smooth.pm10_0 = pm10_filter.addSample(mLatestData.pm10_0);
+#if CONFIG_SEN66_I2C_PROFILE
+    uint64_t busUs, sleepUs;
+    sensirion_i2c_hal_get_time_totals(&busUs, &sleepUs);
+    busUs -= busStartUs;
+    sleepUs -= sleepStartUs;
+    const uint64_t cycleUs = esp_timer_get_time() - cycleStartUs;
+
+    ESP_LOGD(TAG, "Acquisition took %llu us: bus %llu us, sleep %llu us, other %lld us",
+             (unsigned long long)cycleUs, (unsigned long long)busUs, (unsigned long long)sleepUs,
+             (long long)(cycleUs - busUs - sleepUs));
+
+    mProfileCycles++;
+    mProfileCycleUs += cycleUs;
+    mProfileBusUs += busUs;
+    mProfileSleepUs += sleepUs;
+    if (mProfileCycles < kProfileLogCycles)
+        return;
+
+    ESP_LOGI(TAG, "Last %lu acquisitions: avg %llu us, bus %.1f%%, sleep %.1f%%",
+             (unsigned long)mProfileCycles, (unsigned long long)(mProfileCycleUs / mProfileCycles),
+             100.0 * mProfileBusUs / mProfileCycleUs, 100.0 * mProfileSleepUs / mProfileCycleUs);
+    sensirion_i2c_hal_log_profile();
+    sensirion_i2c_hal_log_bus_stats();
+    mProfileCycles = 0;
+    mProfileCycleUs = mProfileBusUs = mProfileSleepUs = 0;
+#else
+    (void)cycleStartUs;
+    (void)busStartUs;
+    (void)sleepStartUs;
+#endif
+}
+
+// Channels the configured module does not have read as NaN and are ignored.
+bool SensorTask::validReading(sen6x::Channel channel, float value)
+{
+    return !sen6x::Active::has(channel) || std::isfinite(value);
+}
+
+void SensorTask::smoothSensorData(sen66_data_t &smooth, bool pmBlanked)
+{
+    smooth.co2_equivalent = mCo2Filter.addSample(mLatestData.co2_equivalent);
+    smooth.voc_index = mVocFilter.addSample(mLatestData.voc_index);
+    smooth.nox_index = mNoxFilter.addSample(mLatestData.nox_index);
+    smooth.hcho = mHchoFilter.addSample(mLatestData.hcho);
+    smooth.temperature = mTempFilter.addSample(mLatestData.temperature);
+    smooth.humidity = mHumFilter.addSample(mLatestData.humidity);
+    if (pmBlanked)
+    {
+        // Hold the published PM and keep the blanked samples out of the
+        // filters, so the cleaning causes no PM report.
+        smooth.pm1_0 = mLastPublished.pm1_0;
+        smooth.pm2_5 = mLastPublished.pm2_5;
+        smooth.pm10_0 = mLastPublished.pm10_0;
+        return;
+    }
+    const PmFilter::Samples &pm = mPmFilter.addSamples({mPmSpikeFilters[kPm1].addSample(mLatestData.pm1_0),
+                                                        mPmSpikeFilters[kPm25].addSample(mLatestData.pm2_5),
+                                                        mPmSpikeFilters[kPm10].addSample(mLatestData.pm10_0)});
+    smooth.pm1_0 = pm[kPm1];
+    smooth.pm2_5 = pm[kPm25];
+    smooth.pm10_0 = pm[kPm10];
 }
 
 bool SensorTask::shouldReport(const sen66_data_t &smooth) const
 {
+    // NaN differences of absent channels compare false.
     return std::fabs(smooth.pm1_0 - mLastPublished.pm1_0) > kPm10Threshold ||
            std::fabs(smooth.pm2_5 - mLastPublished.pm2_5) > kPm25Threshold ||
            std::fabs(smooth.pm10_0 - mLastPublished.pm10_0) > kPm10Threshold ||
            std::fabs(smooth.co2_equivalent - mLastPublished.co2_equivalent) > kCo2Threshold ||
            std::fabs(smooth.voc_index - mLastPublished.voc_index) > kVocThreshold ||
            std::fabs(smooth.nox_index - mLastPublished.nox_index) > kNoxThreshold ||
+           std::fabs(smooth.hcho - mLastPublished.hcho) > kHchoThreshold ||
            std::fabs(smooth.temperature - mLastPublished.temperature) > kTempThreshold ||
            std::fabs(smooth.humidity - mLastPublished.humidity) > kHumThreshold;
 }
@@ -129,13 +429,14 @@ bool SensorTask::shouldReport(const sen66_data_t &smooth) const
 void SensorTask::logChanges(const sen66_data_t &smooth, const sen66_data_t &old) const
 {
     ESP_LOGI(TAG,
-             "Published: ΔPM1=%.1f ΔPM2.5=%.1f ΔPM10=%.1f ΔCO2=%.0f ΔVOC=%.0f ΔNOx=%.0f ΔT=%.1f ΔRH=%.1f",
+             "Published: ΔPM1=%.1f ΔPM2.5=%.1f ΔPM10=%.1f ΔCO2=%.0f ΔVOC=%.0f ΔNOx=%.0f ΔHCHO=%.0f ΔT=%.1f ΔRH=%.1f",
              smooth.pm1_0 - old.pm1_0,
              smooth.pm2_5 - old.pm2_5,
              smooth.pm10_0 - old.pm10_0,
              smooth.co2_equivalent - old.co2_equivalent,
              smooth.voc_index - old.voc_index,
              smooth.nox_index - old.nox_index,
+             smooth.hcho - old.hcho,
              smooth.temperature - old.temperature,
              smooth.humidity - old.humidity);
 }
@@ -17,6 +17,7 @@
 #include <esp_log.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/semphr.h>
 #include <common_macros.h>
 #include <esp_wifi.h>
 #include <nvs_flash.h>
@@ -30,10 +31,13 @@ using namespace chip;
 static const char *TAG = "main";
 
 static MatterAirQuality *matterAirQuality = nullptr; // Global Matter Air Quality object
+static SemaphoreHandle_t sensorReady = nullptr;       // given once the SEN66 bring-up has finished
+static sen66_config_t sensorConfig;                   // SEN66 settings, kept for in-place recovery
 
 // Function declarations
 static void initializeNvs();
 static void initializeHardware();
+static void sensorBringUpTask(void *arg);
 static node_t *createMatterNode();
 static void openCommissioningWindowIfNecessary();
 static void appEventCallback(const DeviceLayer::ChipDeviceEvent *event, intptr_t arg);
@@ -72,15 +76,16 @@ extern "C" void app_main(void)
     // Display Matter pairing information
     displayMatterInfo();
 
+    // Start sensor task once the sensor is up; SNTP is not needed for it
+    xSemaphoreTake(sensorReady, portMAX_DELAY);
+    SensorTask sensorTask(*matterAirQuality, sensorConfig);
+    sensorTask.start();
+
     // Synchronize time using SNTP
     if (!sntp_sync()) {
         ESP_LOGW(TAG, "SNTP synchronization failed");
     }
 
-    // Start sensor task
-    SensorTask sensorTask(*matterAirQuality);
-    sensorTask.start();
-
     // Main loop
     while (true) {
         factory_reset_loop();
@@ -108,11 +113,27 @@ static void initializeNvs()
 static void initializeHardware()
 {
     ESP_LOGI(TAG, "Initializing hardware");
-    sen66_i2c_init(200); // Set sensor altitude to 200 meters
-    sen66_start_measurement();
+    sensorConfig = sen66_default_config();
+    sensorConfig.altitude_m = 200; // Set sensor altitude to 200 meters
+
+    // The SEN66 comes up on its own task while the Matter stack starts
+    sensorReady = xSemaphoreCreateBinary();
+    xTaskCreate(sensorBringUpTask, "sen66_bringup", 4096, nullptr, 5, nullptr);
     factory_reset_init();
 }
 
+//=============================================================================
+// sensorBringUpTask()
+//=============================================================================
+static void sensorBringUpTask(void *)
+{
+    if (!sen66_bring_up(&sensorConfig)) {
+        ESP_LOGE(TAG, "SEN66 bring-up failed; readings will fail until it recovers");
+    }
+    xSemaphoreGive(sensorReady);
+    vTaskDelete(nullptr);
+}
+
 //=============================================================================
 // createMatterNode()
 //=============================================================================